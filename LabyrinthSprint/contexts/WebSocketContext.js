@@ -4,6 +4,7 @@ export const WebSocketContext = createContext(null);
 
 export const WebSocketProvider = ({ children }) => {
     const ws = useRef(null);
+    const lastSeq = useRef(null);
     const [latestGameState, setLatestGameState] = useState(null);
     const [gameOver, setGameOver] = useState(false);
     const [lastGameConfig, setLastGameConfig] = useState(null); // ✅ NEW
@@ -14,7 +15,8 @@ export const WebSocketProvider = ({ children }) => {
     // ✅ New function to send game config and store it
     const sendGameConfig = (config) => {
         if (ws.current?.readyState === WebSocket.OPEN) {
-            const message = { type: 'config', ...config };
+            // Full maze once per level, then position deltas
+            const message = { type: 'config', protocol: 'delta', ...config };
             ws.current.send(JSON.stringify(message));
             setLastGameConfig(config); // ✅ Save it
             console.log('📤 Sent game config:', message);
@@ -37,7 +39,22 @@ export const WebSocketProvider = ({ children }) => {
 
                 if (data.type === 'gameOver') {
                     setGameOver(true);
+                } else if (data.type === 'delta') {
+                    if (lastSeq.current === null || data.seq !== lastSeq.current + 1) {
+                        // Missed a message; ask for a fresh snapshot
+                        lastSeq.current = null;
+                        ws.current.send(JSON.stringify({ type: 'resync' }));
+                        return;
+                    }
+                    lastSeq.current = data.seq;
+                    setLatestGameState((prev) => ({
+                        ...prev,
+                        seq: data.seq,
+                        player: data.p ? { x: data.p[0], y: data.p[1] } : prev?.player,
+                        ai: data.a ? { x: data.a[0], y: data.a[1] } : prev?.ai,
+                    }));
                 } else {
+                    lastSeq.current = data.seq ?? null;
                     setLatestGameState(data);
                 }
             } catch (err) {
@@ -0,0 +1,275 @@
+// Micro-benchmarks for the per-move and per-level hot paths. Each case runs
+// until it has taken at least --min-ms of wall time and reports ns/op plus
+// heap allocations and bytes allocated per op (counted by the global
+// operator new below). --json writes the same rows for diffing builds.
+//
+//     MicroBench [--max-size N] [--min-ms N] [--filter text] [--json path]
+#include "../Game/Declarations/aiController.hpp"
+#include "../Game/Declarations/endlessLabyrinth.hpp"
+#include "../Game/Declarations/labyrinth.hpp"
+#include "../Game/Declarations/logger.hpp"
+#include "../Game/Declarations/messageDecoder.hpp"
+#include "../Game/Declarations/player.hpp"
+#include "../Game/Declarations/wireProtocol.hpp"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> allocatedBytes{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    struct result
+    {
+        std::string name;
+        int size;
+        uint64_t iterations;
+        double nsPerOp;
+        double allocsPerOp;
+        double bytesPerOp;
+    };
+
+    struct options
+    {
+        int maxSize = 4001;
+        double minMs = 200;
+        std::string filter;
+        std::string jsonPath;
+    };
+
+    // Doubles the batch until one batch takes minMs; reports the last batch
+    result measure(const std::string& name, int size, const options& opts, const std::function<void()>& op)
+    {
+        op();   // Warm caches and any lazily built state
+
+        uint64_t batch = 1;
+        while (true) {
+            uint64_t allocsBefore = allocations.load(std::memory_order_relaxed);
+            uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < batch; ++i) op();
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+            if (ns >= opts.minMs * 1e6 || batch >= (uint64_t(1) << 30)) {
+                return { name, size, batch, ns / batch,
+                    double(allocations.load(std::memory_order_relaxed) - allocsBefore) / batch,
+                    double(allocatedBytes.load(std::memory_order_relaxed) - bytesBefore) / batch };
+            }
+            batch *= 2;
+        }
+    }
+
+    // A walker that moves through open cells and restarts at S on reaching E
+    struct walker
+    {
+        labyrinthMap& map;
+        Player player;
+        std::mt19937 rng{ 7 };
+
+        explicit walker(labyrinthMap& map) : map(map), player(1, 'P', map.getStartX(), map.getStartY()) {}
+
+        void step(Player::PlayerDirection dir)
+        {
+            map.setPlayerPosition(player, dir);
+            if (map.gameOver(player)) player.setPosition(map.getStartX(), map.getStartY());
+        }
+
+        Player::PlayerDirection randomDirection()
+        {
+            return static_cast<Player::PlayerDirection>(rng() % 4);
+        }
+    };
+
+    void benchSize(int size, const options& opts, std::vector<result>& results)
+    {
+        auto wanted = [&](const std::string& name) {
+            return opts.filter.empty() || name.find(opts.filter) != std::string::npos;
+        };
+        auto run = [&](const std::string& name, const std::function<void()>& op) {
+            if (!wanted(name)) return;
+            results.push_back(measure(name, size, opts, op));
+            const result& r = results.back();
+            std::cout << std::left << std::setw(22) << r.name << std::setw(7) << r.size
+                << std::right << std::setw(14) << std::fixed << std::setprecision(1) << r.nsPerOp
+                << std::setw(12) << std::setprecision(2) << r.allocsPerOp
+                << std::setw(14) << std::setprecision(1) << r.bytesPerOp << std::endl;
+        };
+
+        run("generateLabyrinth", [&] {
+            labyrinthMap map(size, size);
+            map.generateLabyrinth();
+            });
+
+        {
+            // One maze row (two grid rows) per op, in a ring that never fills
+            endlessLabyrinth endless(size, 1);
+            run("endless.carveRow", [&] {
+                endless.dropBefore(endless.endRow());
+                endless.extendTo(endless.endRow());
+                });
+        }
+
+        labyrinthMap map(size, size);
+        map.generateLabyrinth();
+
+        {
+            walker w(map);
+            run("isValidMove", [&] {
+                volatile bool ok = w.map.isValidMove(w.player, w.randomDirection());
+                (void)ok;
+                });
+            run("setPlayerPosition", [&] { w.step(w.randomDirection()); });
+        }
+
+        const std::pair<const char*, Difficulty> strategies[] = {
+            { "ai.randomMove", EASY }, { "ai.greedyMove", MEDIUM }, { "ai.pathfindingMove", HARD }
+        };
+        for (const auto& [name, difficulty] : strategies) {
+            if (!wanted(name)) continue;
+            auto aiPlayer = std::make_shared<Player>(2, 'A', map.getStartX(), map.getStartY());
+            aiController ai(aiPlayer, map, difficulty);   // HARD builds its distance field here
+            walker w(map);
+            run(name, [&] {
+                w.player.setPosition(aiPlayer->getX(), aiPlayer->getY());
+                w.step(ai.chooseNextMove());
+                aiPlayer->setPosition(w.player.getX(), w.player.getY());
+                });
+        }
+
+        wire::positions pos;
+        pos.playerX = static_cast<uint16_t>(map.getStartX());
+        pos.playerY = static_cast<uint16_t>(map.getStartY());
+        pos.hasAI = true;
+
+        run("serializeToJson", [&] {
+            volatile size_t n = map.serializeToJson().size();
+            (void)n;
+            });
+        // What roomBroadcaster builds per flush, by peer format
+        run("payload.fullJson", [&] {
+            nlohmann::json state;
+            state["labyrinth"] = map.getLabyrinth();
+            state["width"] = map.getWidth();
+            state["height"] = map.getHeight();
+            state["level"] = 1;
+            state["seq"] = 1;
+            state["player"] = { {"x", pos.playerX}, {"y", pos.playerY} };
+            state["ai"] = { {"x", pos.aiX}, {"y", pos.aiY} };
+            volatile size_t n = state.dump().size();
+            (void)n;
+            });
+        run("payload.deltaJson", [&] {
+            nlohmann::json delta;
+            delta["type"] = "delta";
+            delta["seq"] = 1;
+            delta["p"] = { pos.playerX, pos.playerY };
+            delta["a"] = { pos.aiX, pos.aiY };
+            volatile size_t n = delta.dump().size();
+            (void)n;
+            });
+        run("payload.binaryLevel", [&] {
+            volatile size_t n = wire::encodeLevel(map, 1, 1, pos).size();
+            (void)n;
+            });
+        run("payload.binaryUpdate", [&] {
+            volatile size_t n = wire::encodePositionUpdate(1, pos).size();
+            (void)n;
+            });
+    }
+
+    // Parsing doesn't depend on the maze, so it runs once
+    void benchParsing(const options& opts, std::vector<result>& results)
+    {
+        const std::string move = R"({"type":"move","playerId":1,"action":"moveUp"})";
+        const std::string config = R"({"type":"config","mode":"local","difficulty":"hard","protocol":"binary"})";
+        const std::string binaryMove = wire::encodeMove(1, Player::PlayerDirection::MoveUp);
+
+        const std::pair<const char*, std::function<void()>> cases[] = {
+            { "parse.textMove", [&] { wire::inboundMessage m; volatile bool ok = wire::decodeText(move, m); (void)ok; } },
+            { "parse.textConfig", [&] { wire::inboundMessage m; volatile bool ok = wire::decodeText(config, m); (void)ok; } },
+            { "parse.binaryMove", [&] { wire::inboundMessage m; volatile bool ok = wire::decodeBinary(binaryMove, m); (void)ok; } },
+        };
+        for (const auto& [name, op] : cases) {
+            if (!opts.filter.empty() && std::string(name).find(opts.filter) == std::string::npos) continue;
+            results.push_back(measure(name, 0, opts, op));
+            const result& r = results.back();
+            std::cout << std::left << std::setw(22) << r.name << std::setw(7) << "-"
+                << std::right << std::setw(14) << std::fixed << std::setprecision(1) << r.nsPerOp
+                << std::setw(12) << std::setprecision(2) << r.allocsPerOp
+                << std::setw(14) << std::setprecision(1) << r.bytesPerOp << std::endl;
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, options& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            if (arg == "--max-size") opts.maxSize = std::atoi(argv[++i]);
+            else if (arg == "--min-ms") opts.minMs = std::atof(argv[++i]);
+            else if (arg == "--filter") opts.filter = argv[++i];
+            else if (arg == "--json") opts.jsonPath = argv[++i];
+            else return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        std::cerr << "usage: " << argv[0] << " [--max-size N] [--min-ms N] [--filter text] [--json path]\n";
+        return 1;
+    }
+    // Debug-level logging would measure the logger, not the game
+    logging::setLevel(logging::level::Warn);
+
+    std::cout << std::left << std::setw(22) << "case" << std::setw(7) << "size"
+        << std::right << std::setw(14) << "ns/op" << std::setw(12) << "allocs/op" << std::setw(14) << "bytes/op" << "\n";
+
+    std::vector<result> results;
+    benchParsing(opts, results);
+    for (int size : { 21, 101, 501, 1001, 4001 }) {
+        if (size > opts.maxSize) break;
+        benchSize(size, opts, results);
+    }
+
+    if (!opts.jsonPath.empty()) {
+        nlohmann::json rows = nlohmann::json::array();
+        for (const result& r : results) {
+            rows.push_back({ {"name", r.name}, {"size", r.size}, {"iterations", r.iterations},
+                {"ns_per_op", r.nsPerOp}, {"allocs_per_op", r.allocsPerOp}, {"bytes_per_op", r.bytesPerOp} });
+        }
+        std::ofstream(opts.jsonPath) << rows.dump(2) << "\n";
+    }
+
+    logging::flush();
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Compares pathFinder against the hash-map A* that aiController used before
+// the goal distance field, and against its own searches over the junction
+// and cluster graphs. All return full paths; exact lengths are cross-checked,
+// and the cluster search's excess over the shortest path is reported.
+#include "../Game/Declarations/hierarchicalGraph.hpp"
+#include "../Game/Declarations/junctionGraph.hpp"
+#include "../Game/Declarations/labyrinth.hpp"
+#include "../Game/Declarations/pathFinder.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // The previous aiController::pathfindingMove search, returning the path
+    std::vector<std::pair<int, int>> legacyAStar(const labyrinthMap& map, int startX, int startY, int goalX, int goalY)
+    {
+        struct Node {
+            int x, y, g, f;
+            bool operator>(const Node& other) const { return f > other.f; }
+        };
+        auto toKey = [](int x, int y) { return (x << 16) | y; };
+
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openSet;
+        std::unordered_map<int, std::pair<int, int>> cameFrom;
+        std::unordered_map<int, int> gScore;
+
+        openSet.push({ startX, startY, 0, std::abs(goalX - startX) + std::abs(goalY - startY) });
+        gScore[toKey(startX, startY)] = 0;
+
+        const std::pair<Player::PlayerDirection, std::pair<int, int>> directions[4] = {
+            { Player::PlayerDirection::MoveUp, { 0, -1 } },
+            { Player::PlayerDirection::MoveDown, { 0, 1 } },
+            { Player::PlayerDirection::MoveLeft, { -1, 0 } },
+            { Player::PlayerDirection::MoveRight, { 1, 0 } }
+        };
+
+        while (!openSet.empty()) {
+            Node current = openSet.top(); openSet.pop();
+
+            if (current.x == goalX && current.y == goalY) {
+                std::vector<std::pair<int, int>> path{ { goalX, goalY } };
+                int key = toKey(goalX, goalY);
+                while (cameFrom.count(key)) {
+                    path.push_back(cameFrom[key]);
+                    key = toKey(path.back().first, path.back().second);
+                }
+                return path;
+            }
+
+            for (const auto& [dir, delta] : directions) {
+                if (!map.isValidMove(current.x, current.y, dir)) continue;
+                int nx = current.x + delta.first;
+                int ny = current.y + delta.second;
+                int tentativeG = current.g + 1;
+                int key = toKey(nx, ny);
+                if (!gScore.count(key) || tentativeG < gScore[key]) {
+                    gScore[key] = tentativeG;
+                    cameFrom[key] = { current.x, current.y };
+                    openSet.push({ nx, ny, tentativeG, tentativeG + std::abs(goalX - nx) + std::abs(goalY - ny) });
+                }
+            }
+        }
+        return {};
+    }
+
+    template <typename F>
+    double nsPerOp(int iterations, F&& body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) body(i);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    }
+}
+
+int main()
+{
+    const int sizes[] = { 21, 101, 501, 1001 };
+    const int batch = 16;
+    std::mt19937 rng(12345);
+
+    std::cout << std::left << std::setw(8) << "size" << std::setw(16) << "legacy ns/q"
+        << std::setw(16) << "pathFinder ns/q" << std::setw(10) << "speedup"
+        << std::setw(20) << "batch(16) ns/src" << std::setw(14) << "graph ns/q"
+        << std::setw(12) << "cells/node" << std::setw(12) << "hpa ns/q" << "hpa excess" << "\n";
+
+    for (int size : sizes) {
+        labyrinthMap map(size, size);
+        map.generateLabyrinth();
+        map.buildJunctionGraph();
+        const junctionGraph& graph = *map.getJunctionGraph();
+        map.buildHierarchy();
+        const hierarchicalGraph& hierarchy = *map.getHierarchy();
+        int w = map.getWidth();
+        int h = map.getHeight();
+
+        // Even coordinates are always carved by the generator
+        const int queries = size <= 101 ? 200 : 20;
+        std::vector<std::pair<int, int>> pairs;
+        std::uniform_int_distribution<int> cx(0, (w - 1) / 2), cy(0, (h - 1) / 2);
+        for (int i = 0; i < queries; ++i) {
+            pairs.push_back({ map.index(2 * cx(rng), 2 * cy(rng)), map.index(2 * cx(rng), 2 * cy(rng)) });
+        }
+
+        pathFinder finder;
+        std::vector<int> path;
+        size_t mismatches = 0;
+        size_t shortest = 0;
+        size_t hierarchical = 0;
+        for (auto [from, to] : pairs) {
+            finder.findPath(map, from, to, path);
+            shortest += path.size();
+            finder.findPath(map, hierarchy, from, to, path);
+            hierarchical += path.size();
+            finder.findPath(map, from, to, path);
+            auto legacy = legacyAStar(map, from % w, from / w, to % w, to / w);
+            if (legacy.size() != path.size()) ++mismatches;
+            finder.findPath(map, graph, from, to, path);
+            if (legacy.size() != path.size()) ++mismatches;
+        }
+
+        double legacyNs = nsPerOp(queries, [&](int i) {
+            auto [from, to] = pairs[i];
+            auto legacy = legacyAStar(map, from % w, from / w, to % w, to / w);
+            if (legacy.empty()) std::abort();
+            });
+        double finderNs = nsPerOp(queries, [&](int i) {
+            if (!finder.findPath(map, pairs[i].first, pairs[i].second, path)) std::abort();
+            });
+
+        std::vector<int> sources;
+        for (int i = 0; i < batch; ++i) sources.push_back(pairs[i % queries].first);
+        std::vector<std::vector<int>> paths;
+        double batchNs = nsPerOp(queries, [&](int i) {
+            finder.findPaths(map, sources, pairs[i].second, paths);
+            }) / batch;
+        double graphNs = nsPerOp(queries, [&](int i) {
+            if (!finder.findPath(map, graph, pairs[i].first, pairs[i].second, path)) std::abort();
+            });
+        double cellsPerNode = static_cast<double>(graph.getSummary().openCells) / graph.nodeCount();
+        double hierarchyNs = nsPerOp(queries, [&](int i) {
+            if (!finder.findPath(map, hierarchy, pairs[i].first, pairs[i].second, path)) std::abort();
+            });
+        double excess = 100.0 * (static_cast<double>(hierarchical) / shortest - 1);
+
+        std::cout << std::left << std::setw(8) << size << std::setw(16) << std::fixed << std::setprecision(0) << legacyNs
+            << std::setw(16) << finderNs << std::setw(10) << std::setprecision(1) << legacyNs / finderNs
+            << std::setw(20) << std::setprecision(0) << batchNs << std::setw(14) << graphNs
+            << std::setw(12) << std::setprecision(1) << cellsPerNode << std::setw(12) << std::setprecision(0)
+            << hierarchyNs << std::setprecision(2) << excess << "%";
+        if (mismatches) std::cout << "  (" << mismatches << " path length mismatches!)";
+        std::cout << "\n";
+    }
+    return 0;
+}
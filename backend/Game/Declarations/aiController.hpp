@@ -1,12 +1,13 @@
 #ifndef AICONTROLLER_HPP
 #define AICONTROLLER_HPP
 
+#include <chrono>
 #include <memory>
-#include <atomic>
-#include <functional>
 #include "Difficulty.hpp"
+#include "fastRng.hpp"
 #include "player.hpp"
 #include "labyrinth.hpp"
+#include "pathFinder.hpp"
 
 class aiController
 {
@@ -14,24 +15,30 @@ private:
     std::shared_ptr<Player> aiPlayer;
     labyrinthMap& map;
     Difficulty difficulty;
-    std::atomic<bool> running = true;
+    fastRng rng;              // EASY's choices; seeded so a match can be replayed
+
+    // HARD on big levels follows a route planned over the cluster graph
+    // rather than a distance field over every cell
+    static const int HIERARCHY_MIN_CELLS;
+    bool useHierarchy = false;
+    pathFinder finder;
+    std::vector<int> plan;
+    size_t planStep = 0;
 
 public:
-    aiController(std::shared_ptr<Player> ai, labyrinthMap& gameMap, Difficulty diff);
+    aiController(std::shared_ptr<Player> ai, labyrinthMap& gameMap, Difficulty diff, uint64_t seed = fastRng::freshSeed());
 
-    void makeMove(); // Called to perform AI action
+    Player::PlayerDirection makeMove(); // Called to perform AI action; returns the direction tried
     Player::PlayerDirection chooseNextMove();
 
-    // Simplified version that uses internal state
-    void runAI(std::function<bool()> isGameOver);
-
-    void stop();
+    // Pause between moves; the caller schedules turns (no thread of its own)
+    std::chrono::milliseconds stepDelay() const;
 
 private:
     Player::PlayerDirection randomMove();
     Player::PlayerDirection greedyMove();
     Player::PlayerDirection pathfindingMove(); // BFS or A* placeholder
-    Player::PlayerDirection pathfindingMove(Player* player, Game* game);
+    Player::PlayerDirection hierarchicalMove();
 
 };
 
@@ -0,0 +1,43 @@
+#ifndef CHUNKEDMAP_HPP
+#define CHUNKEDMAP_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "labyrinth.hpp"
+
+// A published level cut into square tiles, for peers that only ever see the
+// part of a maze around them. A published level never changes, so a peer
+// needs each tile once per level. Payloads are built on first use and kept
+// with the level.
+//
+// Not thread-safe; the broadcaster owns one per level on its strand.
+class chunkedMap
+{
+private:
+    std::shared_ptr<const labyrinthMap> level;
+    uint32_t levelVersion;
+    int columns, rows;         // Tiles across and down; edge tiles are clipped
+    std::vector<std::string> jsonCache, binaryCache;
+
+public:
+    static const int CHUNK_SIZE;
+
+    chunkedMap(std::shared_ptr<const labyrinthMap> map, uint32_t levelVersion);
+
+    int count() const { return columns * rows; }
+    int chunkX(int chunk) const { return chunk % columns; }
+    int chunkY(int chunk) const { return chunk / columns; }
+
+    // Tiles overlapping the square of `radius` cells around (x, y), row by row
+    void chunksAround(int x, int y, int radius, std::vector<int>& out) const;
+
+    // {"x":cx,"y":cy,"rows":["# #",...]}, S and E marked
+    const std::string& json(int chunk);
+    // wire::encodeChunk of the tile
+    const std::string& binary(int chunk);
+};
+
+#endif // CHUNKEDMAP_HPP
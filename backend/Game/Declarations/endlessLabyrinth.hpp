@@ -0,0 +1,99 @@
+#ifndef ENDLESSLABYRINTH_HPP
+#define ENDLESSLABYRINTH_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fastRng.hpp"
+#include "player.hpp"
+
+// Rows copied out of an endlessLabyrinth for the broadcaster. Same cell
+// layout as the maze (one bit per cell, set = wall), but each row starts on
+// a word boundary so a row can be found without knowing the ones before it.
+struct endlessRows
+{
+    int width = 0;
+    int firstRow = 0;          // Absolute y of the first row
+    int keepFrom = 0;          // Rows below this were dropped by the maze
+    int wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+
+    int count() const { return wordsPerRow ? static_cast<int>(bits.size()) / wordsPerRow : 0; }
+    int endRow() const { return firstRow + count(); }
+    bool isWall(int x, int y) const
+    {
+        return (bits[static_cast<size_t>(y - firstRow) * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+    std::string row(int y) const;   // '#' and ' ', like labyrinthMap::getLabyrinth()
+};
+
+// A maze with no bottom, for endless mode. Rows are carved with Eller's
+// algorithm, which needs only the set label of each cell in the row being
+// carved, and are kept in a ring of `window` rows: the maze is generated a
+// little ahead of the players and forgotten a little behind them, so memory
+// stays the same however deep a run goes.
+//
+// Cells sit on even coordinates as in labyrinthMap, and S is (0, 0). Rows
+// outside the ring, ahead or behind, read as walls.
+class endlessLabyrinth
+{
+private:
+    int width;                 // Grid columns, odd
+    int cells;                 // Maze cells per row, (width + 1) / 2
+    int window;                // Rows the ring holds
+    int wordsPerRow;
+    std::vector<uint64_t> ring;
+    int first = 0;             // Oldest row still held
+    int end = 0;               // One past the newest row
+
+    // Eller state for the next maze row: labels in [1, cells], 0 = new cell
+    fastRng rng;
+    std::vector<uint16_t> sets;
+    std::vector<uint16_t> relabel;     // Scratch, per label
+    std::vector<uint16_t> parent;      // Scratch, per label: union-find
+    std::vector<uint16_t> members;     // Scratch, per label
+    std::vector<uint16_t> chosen;      // Scratch, per label
+    std::vector<uint8_t> right, down;  // Scratch, per cell
+
+    uint64_t* rowWords(int y) { return &ring[static_cast<size_t>(y % window) * wordsPerRow]; }
+    const uint64_t* rowWords(int y) const { return &ring[static_cast<size_t>(y % window) * wordsPerRow]; }
+    void carveRow();
+    uint16_t find(uint16_t label);
+
+public:
+    static const int DEFAULT_WINDOW;
+
+    endlessLabyrinth(int width, uint64_t seed, int window = DEFAULT_WINDOW);
+
+    endlessLabyrinth(const endlessLabyrinth&) = delete;
+    endlessLabyrinth& operator=(const endlessLabyrinth&) = delete;
+
+    // Carves until `row` is held; each maze row adds two grid rows. Stops
+    // early rather than overwrite rows above `first`, so callers must drop
+    // rows before asking for more than `window`. Returns rows added.
+    int extendTo(int row);
+
+    // Forgets every row above `row` (never past the newest)
+    void dropBefore(int row);
+
+    endlessRows copyRows(int from, int to) const;
+
+    bool isWall(int x, int y) const
+    {
+        if (x < 0 || x >= width || y < first || y >= end) return true;
+        return (rowWords(y)[x >> 6] >> (x & 63)) & 1;
+    }
+    bool isValidMove(int fromX, int fromY, Player::PlayerDirection dir) const;
+    bool isValidMove(const Player& player, Player::PlayerDirection dir) const;
+    void setPlayerPosition(Player& player, Player::PlayerDirection dir) const;
+
+    int getWidth() const { return width; }
+    int getWindow() const { return window; }
+    int firstRow() const { return first; }
+    int endRow() const { return end; }
+    int getStartX() const { return 0; }
+    int getStartY() const { return 0; }
+};
+
+#endif // ENDLESSLABYRINTH_HPP
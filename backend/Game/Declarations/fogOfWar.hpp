@@ -0,0 +1,38 @@
+#ifndef FOGOFWAR_HPP
+#define FOGOFWAR_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "labyrinth.hpp"
+
+// What one player has seen of a level, as a bitset over the level's cells.
+// Sight runs along corridors: from the player's cell straight out in each
+// direction up to a wall, taking in the cells to either side of every cell
+// passed. In a maze that is what is in view, and a move costs the length of
+// the corridors it looks down rather than a pass over the grid.
+class fogOfWar
+{
+private:
+    int width, height;
+    std::vector<uint64_t> seen;
+    size_t seenCount = 0;
+
+    void see(const labyrinthMap& map, int x, int y, std::vector<uint32_t>& revealed);
+
+public:
+    explicit fogOfWar(const labyrinthMap& map);
+
+    // Marks everything in view from (x, y) and appends the cells seen for
+    // the first time to `revealed`; returns how many there were
+    size_t revealFrom(const labyrinthMap& map, int x, int y, std::vector<uint32_t>& revealed);
+
+    bool isSeen(int x, int y) const
+    {
+        int cell = y * width + x;
+        return (seen[cell >> 6] >> (cell & 63)) & 1;
+    }
+    size_t seenCells() const { return seenCount; }
+};
+
+#endif // FOGOFWAR_HPP
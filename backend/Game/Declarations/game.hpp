@@ -8,56 +8,117 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
-#include <thread>
+#include <asio.hpp>
 
 #include "labyrinth.hpp"
+#include "endlessLabyrinth.hpp"
+#include "fogOfWar.hpp"
 #include "player.hpp"
 #include "inputHandler.hpp"
 #include "Difficulty.hpp"
 #include "aiController.hpp"  // <-- Added for AI support
+#include "messageDecoder.hpp"
+#include "roomBroadcaster.hpp"
+#include "pendingLevel.hpp"
+#include "mazePool.hpp"
+#include "matchRecorder.hpp"
+#include "fastRng.hpp"
 #include <nlohmann/json.hpp>
 
 typedef websocketpp::server<websocketpp::config::asio> server;
 
+// Everything a room simulates (messages, AI turns) runs on its own strand;
+// sending state to clients runs on the roomBroadcaster's strand
+
 class Game
 {
 private:
     bool isSinglePlayerMode = true;
+    bool isEndlessMode = false;
+    bool isFogMode = false;
     bool configReceived = false;
     bool gameOver = false;
     Difficulty difficulty = EASY;
 
-    std::unique_ptr<labyrinthMap> labyrinth;
-    std::vector<labyrinthMap> levels;
-    server websockerServer;
+    std::shared_ptr<labyrinthMap> labyrinth;     // Shared read-only with the broadcaster once published
+    std::vector<std::shared_ptr<pendingLevel>> levels;   // Built on the pool; null once taken
+    asio::io_context::executor_type generatorPool;
+    mazePool& mazes;          // Owned by roomManager, shared by every room
     int currentLevel = 0;
 
+    // Endless mode plays on this instead of `labyrinth`, one player and no
+    // AI. Rows up to endlessPublished have gone to the broadcaster.
+    std::unique_ptr<endlessLabyrinth> endless;
+    int endlessPublished = 0;
+
+    // Fog mode: what player 1 has seen of the current level. Clients are
+    // only ever sent those cells.
+    std::unique_ptr<fogOfWar> fog;
+    void revealAround(const Player& player);
+
+    // Every random choice in a match (level sizes, mazes, AI) derives from
+    // matchSeed. A seed the client asks for bypasses the shared pool, whose
+    // mazes come from seeds of their own.
+    std::optional<uint64_t> requestedSeed;
+    uint64_t matchSeed = 0;
+    fastRng rng;
+
     std::map<int, std::shared_ptr<Player>> playerMap;
     inputHandler handler;
-    std::set<websocketpp::connection_hdl, std::owner_less<websocketpp::connection_hdl>> connections;
+
+    std::shared_ptr<roomBroadcaster> broadcaster;
+    int levelVersion = 0;     // Bumped whenever `labyrinth` is replaced
 
     std::unique_ptr<aiController> ai;            // <-- AI controller
-    std::shared_ptr<Player> aiAIPlayer;
-    std::unique_ptr<aiController> aiControllerPtr;
-    std::unique_ptr<std::thread> aiThread;
-    // <-- Background thread for AI
+    asio::steady_timer aiTimer;                  // AI turns run on the room's strand
+    std::shared_ptr<int> aiSession;              // Pending turns hold a weak_ptr; reset to orphan them
+
+    std::unique_ptr<recording::matchLog> matchLog;   // Only while recording is on and a match runs
+    void finishRecording();
+
+    void scheduleAiTurn();
+    void stopAi();
 
     void generateSinglePlayerLevels();
     void generateMultiplayerLevel();
-    std::string getGameState();
+    void generateEndlessLevel();
+    void extendEndless();
+    labyrinthMap acquireLevel(int size, uint64_t seed);
+    void publishLevel();
+    gameFrame currentFrame() const;
+
+    // Decoded messages dispatch through messageHandlers, indexed by kind
+    using messageHandler = void (Game::*)(websocketpp::connection_hdl, const wire::inboundMessage&);
+    static const messageHandler messageHandlers[];
+    void dispatch(websocketpp::connection_hdl hdl, const wire::inboundMessage& message);
+    void onUnknownMessage(websocketpp::connection_hdl hdl, const wire::inboundMessage& message);
+    void onConfig(websocketpp::connection_hdl hdl, const wire::inboundMessage& message);
+    void onMove(websocketpp::connection_hdl hdl, const wire::inboundMessage& message);
+    void onResync(websocketpp::connection_hdl hdl, const wire::inboundMessage& message);
 
 public:
-    Game();
+    Game(server& websocketServer, roomExecutor executor, mazePool& mazes);
+    ~Game();
 
     void setSinglePlayerMode(bool isSingle);
+    void setEndlessMode(bool isEndless) { isEndlessMode = isEndless; }
+    void setFogMode(bool isFog) { isFogMode = isFog; }
     void setDifficulty(const std::string& input);
+    void setDifficulty(Difficulty level);
+    void setSeed(std::optional<uint64_t> seed) { requestedSeed = seed; }
+    uint64_t getMatchSeed() const { return matchSeed; }
     void startGame();
 
-    void run();
+    void addConnection(websocketpp::connection_hdl hdl);
+    void removeConnection(websocketpp::connection_hdl hdl);
+
     void nextLevel();
     labyrinthMap& getCurrentlevel();
-    void handlePlayerMove(const std::string& message);
+    void handlePlayerMove(websocketpp::connection_hdl hdl, std::string_view message);
+    void handleBinaryMessage(websocketpp::connection_hdl hdl, std::string_view payload);
+    void applyMove(const std::shared_ptr<Player>& player, Player::PlayerDirection direction);
     void broadcastGameState();
 
     std::string getPlayerInput(int playerId);
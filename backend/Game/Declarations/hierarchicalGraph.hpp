@@ -0,0 +1,78 @@
+#ifndef HIERARCHICALGRAPH_HPP
+#define HIERARCHICALGRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class labyrinthMap;
+
+// Two-level abstraction of a level for HPA*-style searches. The grid is cut
+// into CLUSTER_SIZE squares. Every run of open cell pairs across a cluster
+// border is an entrance, with one transition at its middle: a node on each
+// side joined by a one-step link. Inside a cluster each pair of nodes is
+// joined by its BFS distance there, so a search crosses a cluster in one
+// step and its cost grows with the path length in clusters, not cells.
+// Paths that stay inside the clusters they cross and enter at the middle of
+// each entrance are a close bound on the shortest path; in a maze most
+// entrances are one cell wide, so they are usually exact.
+//
+// Built by labyrinthMap::buildHierarchy; refresh() redoes one cluster and the
+// borders it shares when a wall changes. pathFinder has the searches.
+class hierarchicalGraph
+{
+public:
+    static const int CLUSTER_SIZE;
+
+    struct link
+    {
+        int to;
+        uint32_t cost;
+    };
+
+    struct node
+    {
+        int cell;                  // -1 for a free slot
+        int cluster;
+        std::vector<link> intra;   // Other nodes of the cluster it can reach inside it
+        std::vector<link> inter;   // Its partners across borders, one step away
+    };
+
+    explicit hierarchicalGraph(const labyrinthMap& map);
+
+    size_t nodeCount() const { return nodes.size(); }      // Free slots included
+    size_t liveNodes() const { return nodes.size() - freeNodes.size(); }
+    const node& getNode(int id) const { return nodes[id]; }
+
+    size_t clusterCount() const { return clusters.size(); }
+    int clusterOf(int cell) const { return clusterAt(cell % width, cell / width); }
+    const std::vector<int>& clusterNodes(int cluster) const { return clusters[cluster]; }
+    // Cells of the cluster: x0 <= x < x1, y0 <= y < y1
+    void clusterBounds(int cluster, int& x0, int& y0, int& x1, int& y1) const;
+
+    // Redoes the cluster holding (x, y) after cells in it changed: its
+    // entrances, and the cached distances of it and its neighbours
+    void refresh(const labyrinthMap& map, int x, int y);
+
+private:
+    int width, height;
+    int columns, rows;
+    std::vector<node> nodes;
+    std::vector<int> freeNodes;
+    std::vector<std::vector<int>> clusters;
+    std::unordered_map<int, int> cellNodes;
+
+    // BFS scratch over one cluster, indexed by cell within it
+    std::vector<uint32_t> distances;
+    std::vector<int> queue;
+
+    int clusterAt(int x, int y) const { return (y / CLUSTER_SIZE) * columns + x / CLUSTER_SIZE; }
+    int addNode(int cell);
+    void removeNode(int id);
+    void unlink(int id, int partner);
+    void scanBorder(const labyrinthMap& map, int first, int second);
+    void linkCluster(const labyrinthMap& map, int cluster);
+};
+
+#endif // HIERARCHICALGRAPH_HPP
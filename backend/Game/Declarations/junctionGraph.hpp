@@ -0,0 +1,82 @@
+#ifndef JUNCTIONGRAPH_HPP
+#define JUNCTIONGRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class labyrinthMap;
+
+// A level with its corridors collapsed. Nodes are the cells where a walker
+// has a choice (junctions), dead ends, S and E; edges are the corridors
+// between them, weighted by length. Every open cell maps to a node or to a
+// place along an edge, so searches can run over the graph and still answer
+// in cells. Generated levels have about 2.3 open cells per node, most of the
+// nodes dead ends that a search can pass over.
+//
+// Built in one pass over the grid by labyrinthMap::buildJunctionGraph and
+// read-only after that; pathFinder has the searches.
+class junctionGraph
+{
+public:
+    struct node
+    {
+        int cell;
+        uint32_t firstEdge;      // Into edgesByNode
+        uint32_t degree;
+    };
+
+    // Interior cells (length - 1 of them) sit in corridorCells from
+    // firstCell on, ordered from `from` to `to`
+    struct edge
+    {
+        int from, to;            // Node ids; equal for a corridor looping back
+        uint32_t length;         // Steps from one end to the other
+        uint32_t firstCell;
+    };
+
+    struct summary
+    {
+        size_t openCells = 0;
+        size_t junctions = 0;    // Nodes with 3 or 4 exits
+        size_t deadEnds = 0;     // Nodes with 1 exit
+        uint32_t longestCorridor = 0;
+        double meanCorridor = 0;
+    };
+
+    explicit junctionGraph(const labyrinthMap& map);
+
+    size_t nodeCount() const { return nodes.size(); }
+    size_t edgeCount() const { return edges.size(); }
+    const node& getNode(int id) const { return nodes[id]; }
+    const edge& getEdge(int id) const { return edges[id]; }
+    const summary& getSummary() const { return stats; }
+
+    // Edge ids leaving node `id`; loops are left out
+    const uint32_t* edgesOf(int id) const { return edgesByNode.data() + nodes[id].firstEdge; }
+    static int otherEnd(const edge& e, int id) { return e.from == id ? e.to : e.from; }
+
+    // Where an open cell sits: a node (nodeAt >= 0), or an edge and its
+    // steps from the edge's `from` end (edgeAt >= 0). Walls are neither.
+    int nodeAt(int cell) const { return location[cell] <= -2 ? -2 - location[cell] : -1; }
+    int edgeAt(int cell) const { return location[cell]; }
+    uint32_t offsetOnEdge(int cell) const { return offsets[cell]; }
+
+    // The cell `steps` from the edge's `from` end, nodes included
+    int cellOnEdge(int id, uint32_t steps) const;
+
+private:
+    std::vector<node> nodes;
+    std::vector<edge> edges;
+    std::vector<uint32_t> edgesByNode;
+    std::vector<int> corridorCells;
+    std::vector<int32_t> location;     // Per cell: edge id, -2 - node id, or -1 for walls
+    std::vector<uint32_t> offsets;     // Per corridor cell
+    summary stats;
+
+    int addNode(int cell);
+    void walkCorridor(const labyrinthMap& map, int fromNode, int firstCell);
+    void linkNodes();
+};
+
+#endif // JUNCTIONGRAPH_HPP
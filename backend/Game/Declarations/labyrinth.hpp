@@ -1,37 +1,63 @@
 #ifndef LABYRINTH_HPP
 #define LABYRINTH_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <string>
 #include "player.hpp"
-#include "inputHandler.hpp"
 #include <nlohmann/json.hpp>
 
+class junctionGraph;
+class hierarchicalGraph;
+
 class labyrinthMap {
 private:
     int width, height;
-    std::vector<std::string> labyrinth;
-    inputHandler handler;
+    // One bit per cell, row-major (index = y * width + x); a set bit is a wall.
+    // S and E are the only special tiles, so they are kept as coordinates.
+    std::vector<uint64_t> walls;
+    // What isWall reads: walls.data(), or grid words borrowed from a mapped
+    // maze library and kept alive by wallBacking
+    const uint64_t* wallWords = nullptr;
+    std::shared_ptr<const void> wallBacking;
     int startX = 0;
     int startY = 0;
+    int endX = -1;
+    int endY = -1;
+    // BFS steps from E per cell (UNREACHABLE for walls); empty until built
+    std::vector<uint32_t> goalDistances;
+    // Corridor-compressed graph of the level; null until built
+    std::shared_ptr<const junctionGraph> junctions;
+    // Cluster graph for searches on big levels; null until built
+    std::unique_ptr<hierarchicalGraph> hierarchy;
+
+    void setWall(int x, int y, bool wall);
+    char cellAt(int x, int y) const;
 
 
 public:
     // Constructors and destructor
     labyrinthMap();
     labyrinthMap(int width, int height);
-    labyrinthMap(labyrinthMap&&) noexcept = default;
-    labyrinthMap& operator=(labyrinthMap&&) noexcept = default;
+    // Zero-copy view of a finished grid (same word layout as `walls`)
+    labyrinthMap(int width, int height, int startX, int startY, int endX, int endY,
+        const uint64_t* words, std::shared_ptr<const void> backing);
+    labyrinthMap(labyrinthMap&&) noexcept;
+    labyrinthMap& operator=(labyrinthMap&&) noexcept;
 
     // Deleted copy operations
     labyrinthMap(const labyrinthMap&) = delete;
     labyrinthMap& operator=(const labyrinthMap&) = delete;
 
-    ~labyrinthMap() = default;
+    ~labyrinthMap();
 
-    // Maze generation
+    // Maze generation. The same seed always gives the same maze; without
+    // one, a fresh seed is drawn.
     void generateLabyrinth();
+    void generateLabyrinth(uint64_t seed);
     static const char WALL;
 
     // Game mechanics
@@ -44,6 +70,27 @@ public:
     bool isValidMove(int fromX, int fromY, Player::PlayerDirection dir) const;
     std::pair<int, int> getEndPosition() const;
 
+    // Goal distance field: one BFS from E per level, shared by every agent
+    static const uint32_t UNREACHABLE;
+    void buildGoalDistances();
+    bool hasGoalDistances() const { return !goalDistances.empty(); }
+    uint32_t goalDistance(int x, int y) const { return goalDistances[index(x, y)]; }
+    bool stepTowardGoal(int x, int y, Player::PlayerDirection& out) const;
+
+    // Junction graph: built once per level by Game::publishLevel, before the
+    // level is shared
+    void buildJunctionGraph();
+    const junctionGraph* getJunctionGraph() const { return junctions.get(); }
+
+    // Cluster graph: built once per level; editWall keeps it current
+    void buildHierarchy();
+    const hierarchicalGraph* getHierarchy() const { return hierarchy.get(); }
+
+    // Changes one cell after generation, before the level is published:
+    // published levels are read by the broadcaster and never change. The
+    // distance field and junction graph are dropped, to be rebuilt on next
+    // use; the cluster graph is refreshed around the cell.
+    void editWall(int x, int y, bool wall);
 
 
     // Serialization and output
@@ -51,20 +98,26 @@ public:
     std::string serializeToJson() const;
     void printLabyrinth() const;
 
+    // Single bit test; callers must stay inside the grid
+    int index(int x, int y) const { return y * width + x; }
+    bool isWall(int cell) const { return (wallWords[cell >> 6] >> (cell & 63)) & 1; }
+    bool isWall(int x, int y) const { return isWall(index(x, y)); }
+    bool inBounds(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+
     // Accessors
-    const std::vector<std::string>& getLabyrinth() const;
+    std::vector<std::string> getLabyrinth() const;   // Row strings, built on demand
+    const uint64_t* getWallBits() const { return wallWords; }
+    size_t getWallWordCount() const { return (static_cast<size_t>(width) * height + 63) / 64; }
     int getWidth() const;
     int getHeight() const;
     int getStartX() const { return startX; }
     int getStartY() const { return startY; }
+    int getEndX() const { return endX; }
+    int getEndY() const { return endY; }
 
 
     // Optional: Direct data setting if needed
-    void setLabyrinthData(std::vector<std::string>&& newLab, int newW, int newH) {
-        labyrinth = std::move(newLab);
-        width = newW;
-        height = newH;
-    }
+    void setLabyrinthData(std::vector<std::string>&& newLab, int newW, int newH);
 };
 
 #endif
@@ -0,0 +1,76 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Lowest level compiled in: 0 debug, 1 info, 2 warn, 3 error. Debug records
+// are stripped from release builds unless the build asks for them.
+#ifndef LABYRINTH_LOG_LEVEL
+#ifdef NDEBUG
+#define LABYRINTH_LOG_LEVEL 1
+#else
+#define LABYRINTH_LOG_LEVEL 0
+#endif
+#endif
+
+// Asynchronous structured logging. A call copies the message pointer, the
+// fields and a timestamp into a ring buffer owned by the calling thread; a
+// background writer drains every ring and does the formatting and I/O. The
+// calling thread never blocks or touches a stream. If a ring fills up, the
+// record is dropped and counted instead.
+//
+//     LOG_INFO("Player moved", { {"player", id}, {"x", x}, {"y", y} });
+//
+// Messages and keys must be string literals; text values are copied
+// (truncated if very long).
+namespace logging
+{
+    enum class level : uint8_t { Debug, Info, Warn, Error };
+
+    constexpr bool compiledIn(level lvl) { return static_cast<int>(lvl) >= LABYRINTH_LOG_LEVEL; }
+
+    struct field
+    {
+        const char* key;
+        bool isText;
+        int64_t number;
+        std::string_view text;
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, int>::type = 0>
+        field(const char* key, T value) : key(key), isText(false), number(static_cast<int64_t>(value)) {}
+        field(const char* key, std::string_view value) : key(key), isText(true), number(0), text(value) {}
+        field(const char* key, const char* value) : field(key, std::string_view(value)) {}
+        field(const char* key, const std::string& value) : field(key, std::string_view(value)) {}
+    };
+
+    // Runtime floor on top of the compile-time one
+    void setLevel(level lvl);
+    bool enabled(level lvl);
+    bool parseLevel(std::string_view name, level& out);
+
+    void write(level lvl, const char* message, std::initializer_list<field> fields = {});
+
+    // Blocks until everything logged so far has been written
+    void flush();
+
+    uint64_t droppedCount();
+}
+
+// Arguments are not evaluated when the level is compiled out or disabled
+#define LABYRINTH_LOG(lvl, ...) \
+    do { \
+        if constexpr (logging::compiledIn(lvl)) { \
+            if (logging::enabled(lvl)) logging::write(lvl, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(...) LABYRINTH_LOG(logging::level::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  LABYRINTH_LOG(logging::level::Info, __VA_ARGS__)
+#define LOG_WARN(...)  LABYRINTH_LOG(logging::level::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LABYRINTH_LOG(logging::level::Error, __VA_ARGS__)
+
+#endif // LOGGER_HPP
@@ -0,0 +1,131 @@
+#ifndef MATCHRECORDER_HPP
+#define MATCHRECORDER_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "labyrinth.hpp"
+#include "player.hpp"
+
+// Match recordings ("LBMR" files). A file is a 8-byte header followed by
+// chunks, each `varint matchId, varint length, bytes`; the chunks of one
+// match concatenate into its event stream. An empty chunk is a tombstone:
+// some of the match was dropped, so the whole match is discarded. Every event starts with its type
+// and the microseconds since the previous event, all as unsigned varints:
+//
+//     Match  mode, difficulty, wall clock start (us since epoch), seed
+//            (version 2 on)
+//     Level  version, width, height, start x/y, end x/y, player count,
+//            (id, x, y) per player, then the wall bits as raw u64 words
+//     Move   player id, direction, resulting x, y
+//     Win    player id
+//     End
+//
+// Moves carry the position the server computed, so a replay can check that
+// re-simulating the maze reproduces it.
+namespace recording
+{
+    enum class eventType : uint8_t { Match = 1, Level, Move, Win, End };
+
+    struct playerPosition
+    {
+        int id, x, y;
+    };
+
+    struct matchEvent
+    {
+        eventType type = eventType::End;
+        uint64_t micros = 0;         // Since the start of the match
+
+        int mode = 0;                // 0 single, 1 local
+        int difficulty = 0;
+        uint64_t wallMicros = 0;
+        uint64_t seed = 0;
+
+        int level = 0;
+        int width = 0, height = 0;
+        int startX = 0, startY = 0, endX = 0, endY = 0;
+        std::vector<playerPosition> players;
+        std::vector<uint64_t> walls;
+
+        int playerId = 0;
+        Player::PlayerDirection direction = Player::PlayerDirection::MoveUp;
+        int x = 0, y = 0;
+    };
+
+    // Events of one match, encoded on the room's strand into a private
+    // buffer. Big matches hand full buffers to the recorder as they go; the
+    // rest is handed over by end().
+    class matchLog
+    {
+    private:
+        uint64_t id;
+        std::string buffer;
+        int64_t lastMicros;
+        bool dropped = false;    // A chunk was dropped; the rest is not kept either
+
+        void begin(eventType type);
+        void handOff();
+
+    public:
+        explicit matchLog(uint64_t id);
+
+        void match(bool singlePlayer, int difficulty, uint64_t seed);
+        void level(int version, const labyrinthMap& map, const std::map<int, std::shared_ptr<Player>>& players);
+        void move(int playerId, Player::PlayerDirection direction, int x, int y);
+        void win(int playerId);
+        void end();
+    };
+
+    // Process-wide sink. Chunks are queued and appended to the file by a
+    // background thread; when the queue is over its byte budget, chunks are
+    // dropped and counted rather than blocking a room, and a tombstone for
+    // the match takes their place.
+    namespace recorder
+    {
+        bool open(const std::string& path);
+        bool enabled();
+        uint64_t nextMatchId();
+        // False when the chunk was dropped or nothing is recording
+        bool submit(uint64_t matchId, const std::string& events);
+
+        // Writes everything queued so far and stops the writer
+        void close();
+
+        uint64_t droppedChunks();
+    }
+
+    // Reads a whole file and joins each match's chunks, keyed by match id;
+    // `version` is what the events need to be read with. Matches with a
+    // tombstone are left out of `matches` and listed in `dropped`.
+    bool readFile(const std::string& path, std::map<uint64_t, std::string>& matches, uint16_t& version,
+        std::set<uint64_t>& dropped);
+
+    // Walks one match's event stream
+    class eventReader
+    {
+    private:
+        std::string_view data;
+        uint16_t version;
+        size_t at = 0;
+        uint64_t clock = 0;
+        bool bad = false;
+
+        bool varint(uint64_t& out);
+        bool number(int& out);
+
+    public:
+        eventReader(std::string_view events, uint16_t version) : data(events), version(version) {}
+
+        // False at the end of the stream or on a malformed event
+        bool next(matchEvent& out);
+        bool failed() const { return bad; }
+    };
+}
+
+#endif // MATCHRECORDER_HPP
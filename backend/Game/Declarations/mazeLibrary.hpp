@@ -0,0 +1,72 @@
+#ifndef MAZELIBRARY_HPP
+#define MAZELIBRARY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "labyrinth.hpp"
+
+// Pre-generated mazes baked to disk (see Tools/mazeBake.cpp) and mapped at
+// startup, so a cold server can serve its first games without generating.
+// Mazes are handed out as labyrinthMaps that borrow their grid straight from
+// the mapping. A library never runs dry: each size cycles through its mazes.
+//
+// File layout, little-endian, version 1:
+//   header  magic "LBML", u16 version, u16 header size, u32 entry count,
+//           u32 entry size, u64 index offset, u64 reserved
+//   index   per maze: u16 width, height, startX, startY, endX, endY,
+//           u32 shortest path (S to E steps), u64 grid offset,
+//           u32 grid words, u32 reserved
+//   grids   8-byte aligned u64 words, bit-packed like labyrinthMap::walls
+class mazeLibrary : public std::enable_shared_from_this<mazeLibrary>
+{
+public:
+    static const uint16_t VERSION = 1;
+
+    struct entry
+    {
+        uint16_t width, height;
+        uint16_t startX, startY, endX, endY;
+        uint32_t shortestPath;
+        uint64_t gridOffset;
+        uint32_t gridWords;
+    };
+
+    // Null (after logging why) if the file is missing or malformed
+    static std::shared_ptr<mazeLibrary> open(const std::string& path);
+
+    static bool write(const std::string& path, const std::vector<labyrinthMap>& mazes);
+
+    // Sizes are normalized the way labyrinthMap's constructor does it
+    bool take(int width, int height, labyrinthMap& out);
+
+    size_t size() const { return entries.size(); }
+    const std::vector<entry>& index() const { return entries; }
+
+    ~mazeLibrary();
+
+private:
+    struct sizeBucket
+    {
+        std::vector<uint32_t> entries;
+        std::atomic<uint32_t> next{ 0 };
+    };
+
+    const unsigned char* data = nullptr;
+    size_t length = 0;
+    std::vector<unsigned char> fallback;    // File contents where mmap is unavailable
+    std::vector<entry> entries;
+    std::map<std::pair<int, int>, sizeBucket> bySize;
+
+    mazeLibrary() = default;
+    bool load(const std::string& path);
+    bool parse();
+};
+
+#endif // MAZELIBRARY_HPP
@@ -0,0 +1,86 @@
+#ifndef MAZEPOOL_HPP
+#define MAZEPOOL_HPP
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "labyrinth.hpp"
+#include "mazeLibrary.hpp"
+
+// Per-size watermarks: refill below lowWater, stop at highWater. A baked
+// maze library, if given, covers sizes the pool has not filled yet.
+struct mazePoolConfig
+{
+    size_t lowWater = 2;
+    size_t highWater = 6;
+    std::string libraryPath;
+};
+
+// Finished mazes kept ready per size, shared by every room. Difficulty only
+// enters through the size, and there is a single generator, so (width,
+// height) is the whole key. Taking a maze is a pop; when a size drops below
+// its low watermark, the thread pool refills it to the high watermark one
+// maze per task, so refills never hold a pool thread for long. A size gets a
+// bucket the first time it is asked for.
+class mazePool
+{
+public:
+    struct stats
+    {
+        uint64_t hits = 0;
+        uint64_t libraryHits = 0;
+        uint64_t misses = 0;
+        uint64_t generated = 0;   // By refills; misses build their own
+        size_t ready = 0;
+    };
+
+    mazePool(asio::io_context::executor_type pool, mazePoolConfig settings = {});
+
+    mazePool(const mazePool&) = delete;
+    mazePool& operator=(const mazePool&) = delete;
+
+    // Pops a ready maze, else borrows one from the library; counts which
+    bool tryAcquire(int width, int height, labyrinthMap& out);
+
+    // Like tryAcquire, but builds the maze on the caller's thread on a miss
+    labyrinthMap acquire(int width, int height);
+
+    stats snapshot();
+
+private:
+    struct bucket
+    {
+        std::vector<labyrinthMap> ready;
+        bool refilling = false;
+    };
+
+    asio::io_context::executor_type pool;
+    mazePoolConfig settings;
+
+    std::mutex mutex;
+    std::map<std::pair<int, int>, bucket> buckets;
+
+    std::shared_ptr<mazeLibrary> library;
+
+    std::atomic<uint64_t> hits{ 0 };
+    std::atomic<uint64_t> libraryHits{ 0 };
+    std::atomic<uint64_t> misses{ 0 };
+    std::atomic<uint64_t> generated{ 0 };
+
+    // Both expect `mutex` held
+    bucket& bucketFor(int width, int height);
+    void scheduleRefill(int width, int height, bucket& b);
+
+    void refillOne(int width, int height);
+};
+
+#endif // MAZEPOOL_HPP
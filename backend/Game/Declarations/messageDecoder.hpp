@@ -0,0 +1,46 @@
+#ifndef MESSAGEDECODER_HPP
+#define MESSAGEDECODER_HPP
+
+#include <cstdint>
+#include <string_view>
+#include "Difficulty.hpp"
+#include "player.hpp"
+#include "wireProtocol.hpp"
+
+namespace wire
+{
+    // One inbound message, JSON or binary, decoded in a single pass. Text
+    // fields are views into the original payload, so the payload must
+    // outlive the struct.
+    struct inboundMessage
+    {
+        enum class kind : uint8_t { Unknown, Config, Move, Resync, Count };
+        enum class gameMode : uint8_t { Single, Local, Endless, Unrecognized };
+
+        kind type = kind::Unknown;
+
+        // Config
+        gameMode mode = gameMode::Single;
+        Difficulty difficulty = EASY;
+        wireFormat protocol = wireFormat::JsonFull;
+        std::string_view rawMode;   // For the unknown-mode warning only
+        bool hasSeed = false;       // "seed": number, or decimal string past 2^53
+        uint64_t seed = 0;
+        bool fog = false;           // "fog": true
+
+        // Move
+        int playerId = -1;
+        bool hasDirection = false;
+        Player::PlayerDirection direction = Player::PlayerDirection::MoveUp;
+    };
+
+    // Flat-object JSON scanner: {"type":"config",...}, {"type":"resync"} or
+    // {"playerId":1,"action":"MoveUp"}. Nested values are skipped. Returns
+    // false on malformed input.
+    bool decodeText(std::string_view text, inboundMessage& out);
+
+    // MoveInput and Resync frames from wireProtocol.hpp
+    bool decodeBinary(std::string_view payload, inboundMessage& out);
+}
+
+#endif // MESSAGEDECODER_HPP
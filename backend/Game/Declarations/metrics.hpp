@@ -0,0 +1,107 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+// Process-wide latency histograms and counters, rendered in the Prometheus
+// text format for GET /metrics. Recording is a few relaxed atomic adds, so
+// it is safe from any thread and cheap enough for the per-move path.
+//
+//     { metrics::timer t(metrics::stage::Decode); decode(...); }
+namespace metrics
+{
+    enum class stage : uint8_t
+    {
+        Receive,     // Socket thread hand-off until the room strand runs the message
+        Decode,      // Text or binary payload -> inboundMessage
+        Apply,       // Move validation and player update
+        Serialize,   // Building and dumping one broadcast payload
+        Send,        // One websocketpp send call
+        AiStep,      // One AI move
+        Generate,    // One maze generation
+        Count
+    };
+
+    enum class counter : uint8_t
+    {
+        MessagesIn,
+        BytesOut,
+        FailedSends,
+        MalformedMessages,
+        Count
+    };
+
+    // Log-linear buckets in the HDR style: 16 per power of two, so a
+    // reported value is within 1/16 of the recorded one. Values are
+    // nanoseconds, clamped at about 18 minutes.
+    class histogram
+    {
+    public:
+        static constexpr int SUB_BITS = 4;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+        static constexpr int MAX_BITS = 40;
+        static constexpr int BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+        struct summary
+        {
+            uint64_t count = 0;
+            uint64_t sum = 0;
+            uint64_t max = 0;
+            std::array<uint64_t, BUCKETS> buckets{};
+
+            // Highest value in the bucket holding quantile q
+            uint64_t quantile(double q) const;
+        };
+
+        void record(uint64_t nanos);
+        summary snapshot() const;
+
+        static int bucketFor(uint64_t value);
+        static uint64_t upperBound(int bucket);
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+        std::atomic<uint64_t> sum{ 0 };
+        std::atomic<uint64_t> max{ 0 };
+    };
+
+    void record(stage s, std::chrono::steady_clock::duration elapsed);
+    void add(counter c, uint64_t amount = 1);
+
+    histogram::summary snapshot(stage s);
+    uint64_t value(counter c);
+
+    // Records the time from construction to destruction
+    class timer
+    {
+    public:
+        explicit timer(stage s) : s(s), start(std::chrono::steady_clock::now()) {}
+        ~timer() { record(s, std::chrono::steady_clock::now() - start); }
+
+        timer(const timer&) = delete;
+        timer& operator=(const timer&) = delete;
+
+    private:
+        stage s;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // A value owned by someone else (room counts, pool stats), added to the
+    // scrape by its caller
+    struct sample
+    {
+        const char* name;
+        const char* help;
+        const char* type;    // "gauge" or "counter"
+        double value;
+    };
+
+    std::string render(std::initializer_list<sample> extra = {});
+}
+
+#endif // METRICS_HPP
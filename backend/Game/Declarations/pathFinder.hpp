@@ -0,0 +1,86 @@
+#ifndef PATHFINDER_HPP
+#define PATHFINDER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "player.hpp"
+#include "labyrinth.hpp"
+#include "junctionGraph.hpp"
+#include "hierarchicalGraph.hpp"
+
+// Reusable point-to-point search over a labyrinthMap's flat cell index
+// (index = y * width + x). Scratch arrays are generation-stamped, so a query
+// never clears or allocates once they have grown to the grid size; paths are
+// written into caller-owned vectors that keep their capacity between calls.
+// Not thread-safe: use one pathFinder per thread.
+class pathFinder
+{
+private:
+    static const int RING = 4;   // Unit costs + Manhattan: live f values span at most 3
+
+    int width = 0;
+    int height = 0;
+    uint32_t generation = 0;
+    size_t expanded = 0;
+
+    std::vector<uint32_t> seen;      // == generation once g/parent are valid this query
+    std::vector<uint32_t> closed;    // == generation once expanded
+    std::vector<uint32_t> g;
+    std::vector<int> parent;
+    std::vector<int> buckets[RING];  // Open list: LIFO buckets keyed by f % RING
+    std::vector<int> frontier;       // BFS queue for batched queries
+
+    // Graph searches: the same stamps, per node instead of per cell
+    std::vector<uint32_t> nodeSeen;
+    std::vector<uint32_t> nodeClosed;
+    std::vector<uint32_t> nodeG;
+    std::vector<int> nodeParent;     // -1: reached straight from the source
+    std::vector<int> nodeVia;        // Edge taken to reach the node
+    std::vector<std::pair<uint32_t, int>> heap;   // (f, node), min-heap
+    std::vector<std::pair<int, uint32_t>> exits;  // Target-cluster nodes and their cost to the target
+    std::vector<int> chain;
+
+    void prepareNodes(size_t count);
+    static void walkEdge(const junctionGraph& graph, int edge, uint32_t from, uint32_t to, std::vector<int>& path);
+    uint32_t searchCluster(const labyrinthMap& map, const hierarchicalGraph& graph, int from);
+    bool appendClusterPath(const labyrinthMap& map, const hierarchicalGraph& graph, int from, int to, std::vector<int>& path);
+
+    void prepare(const labyrinthMap& map);
+    uint32_t nextGeneration();
+    bool isOpen(const labyrinthMap& map, int cell) const;
+    void tracePath(int to, std::vector<int>& path) const;
+
+public:
+    pathFinder() = default;
+
+    // A* from `from` to `to`; fills `path` with every cell including both ends
+    bool findPath(const labyrinthMap& map, int from, int to, std::vector<int>& path);
+
+    // Shortest path length in steps, or -1 if unreachable
+    int distance(const labyrinthMap& map, int from, int to);
+
+    // One BFS from `to` serves every source; paths[i] is empty if sources[i]
+    // cannot reach it. Returns how many sources were reachable.
+    size_t findPaths(const labyrinthMap& map, const std::vector<int>& sources, int to,
+        std::vector<std::vector<int>>& paths);
+
+    // The same answers over the level's junction graph: A* across nodes,
+    // with corridors crossed in one step and mapped back to cells. Expands
+    // junctions instead of cells.
+    bool findPath(const labyrinthMap& map, const junctionGraph& graph, int from, int to, std::vector<int>& path);
+    int distance(const labyrinthMap& map, const junctionGraph& graph, int from, int to);
+
+    // Near-shortest path over the level's cluster graph: A* across entrance
+    // nodes, then each cluster crossing expanded to cells. Work grows with
+    // the clusters crossed, so it suits big levels and many agents with
+    // different goals. The graph must not be refreshed during a query.
+    bool findPath(const labyrinthMap& map, const hierarchicalGraph& graph, int from, int to, std::vector<int>& path);
+
+    // Cells (or nodes) expanded by the last query, for analytics and benchmarks
+    size_t lastExpanded() const { return expanded; }
+
+    // Direction of a single step between two adjacent cells
+    static Player::PlayerDirection directionBetween(const labyrinthMap& map, int from, int to);
+};
+
+#endif // PATHFINDER_HPP
@@ -0,0 +1,42 @@
+#ifndef PENDINGLEVEL_HPP
+#define PENDINGLEVEL_HPP
+
+#include <asio.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "labyrinth.hpp"
+
+// A maze being generated on the shared thread pool. Whoever needs it first
+// builds it: take() waits only for a build that a worker has already started,
+// and builds inline if the worker has not got to it yet. Waiting on a queued
+// task could deadlock a pool with a single thread. A build that is still
+// queued when its pendingLevel is dropped is skipped.
+class pendingLevel
+{
+private:
+    enum class state { Queued, Building, Ready, Taken };
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    state status = state::Queued;
+    labyrinthMap map;
+    uint64_t seed = 0;
+
+    bool claim();
+    void build();
+
+public:
+    pendingLevel(int width, int height, uint64_t seed);
+    explicit pendingLevel(labyrinthMap finished);
+
+    static std::shared_ptr<pendingLevel> generateAsync(asio::io_context::executor_type pool, int width, int height, uint64_t seed);
+
+    // Call at most once
+    labyrinthMap take();
+};
+
+#endif // PENDINGLEVEL_HPP
@@ -4,16 +4,15 @@
 #include <iostream>
 #include <memory> // For std::unique_ptr
 #include <string>
+#include <string_view>
 #include <utility> // For std::pair
 #include <nlohmann/json.hpp>
-#include "inputHandler.hpp"
 
 class Player {
 private:
     int Id;
     char character; // 'P' for player
     int x, y;
-    std::unique_ptr<inputHandler> inputHandlerPtr;
     int mapSize;
 
 public:
@@ -44,10 +43,10 @@ public:
     // Movement and update functions
     void move(PlayerDirection direction);
     void setPosition(int x, int y);
-    void update(std::string message);
 
     // Direction conversion
     static PlayerDirection stringToDirection(const std::string& actionInput);
+    static bool tryParseDirection(std::string_view action, PlayerDirection& out); // Case-insensitive, no allocation
     std::pair<int, int> actionToDelta(const std::string& action);
 
     // Getters and Setters
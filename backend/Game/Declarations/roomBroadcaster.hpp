@@ -0,0 +1,129 @@
+#ifndef ROOMBROADCASTER_HPP
+#define ROOMBROADCASTER_HPP
+
+#include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/server.hpp>
+#include <asio.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "labyrinth.hpp"
+#include "chunkedMap.hpp"
+#include "endlessLabyrinth.hpp"
+#include "seqlock.hpp"
+#include "wireProtocol.hpp"
+#include <nlohmann/json.hpp>
+
+typedef websocketpp::server<websocketpp::config::asio> server;
+typedef asio::strand<asio::io_context::executor_type> roomExecutor;
+
+// Everything a broadcast needs to know about the moving parts of a match
+struct gameFrame
+{
+    int32_t level = -1;       // Game's levelVersion
+    bool hasPlayer = false;
+    int32_t playerX = 0, playerY = 0;
+    bool hasAI = false;
+    int32_t aiX = 0, aiY = 0;
+};
+
+// What one connection has negotiated and already received
+struct peerState
+{
+    wireFormat format = wireFormat::JsonFull;
+    int knownLevel = -1;      // levelVersion of the last full snapshot sent
+    int knownRow = 0;         // Endless levels: rows above this were sent
+    std::vector<bool> chunks;      // Chunked formats: tiles held
+    size_t knownRevealed = 0;      // Fog levels: revealed cells sent
+};
+
+// Outbound half of a room. The simulation publishes frames into a seqlock
+// buffer and levels as immutable shared maps; serialization and sends run on
+// this object's own strand, so they can use another core than the simulation
+// and never take a lock on the move path. Bursts of frames coalesce into one
+// send of the newest state.
+class roomBroadcaster : public std::enable_shared_from_this<roomBroadcaster>
+{
+private:
+    server& websocketServer;
+    roomExecutor outbox;
+
+    seqlockBuffer<gameFrame> frames;
+    std::atomic<bool> flushPending{ false };
+
+    // Outbox-strand state
+    std::map<websocketpp::connection_hdl, peerState, std::owner_less<websocketpp::connection_hdl>> connections;
+    std::shared_ptr<const labyrinthMap> level;
+    int levelVersion = -1;
+    nlohmann::json levelRows;  // getLabyrinth() of `level`, built once per level
+    uint64_t stateSeq = 0;     // Bumped on every flush
+
+    // Endless levels have no `level`; their rows arrive in batches, and the
+    // batches still inside the maze's window are kept for late joiners. Each
+    // batch's payloads are built the first time a peer needs them.
+    struct rowBatch
+    {
+        std::shared_ptr<const endlessRows> rows;
+        std::string json, binary;
+    };
+    bool endlessLevel = false;
+    std::deque<rowBatch> rowBatches;
+
+    // Fog-of-war levels: the cells the player has seen, in the order seen.
+    // Every peer is sent a prefix of them, and never the rest of the maze.
+    bool fogLevel = false;
+    std::vector<uint32_t> revealed;
+
+    // Tiles of `level`, built when the first chunked peer needs one
+    std::unique_ptr<chunkedMap> tiles;
+    std::vector<int> viewport;                   // Scratch for sendChunks
+    std::vector<const std::string*> pending;     // Scratch for sendChunks
+
+    void flush();
+    void flushEndless(const gameFrame& frame);
+    void sendRows(websocketpp::connection_hdl hdl, peerState& peer);
+    void sendChunks(websocketpp::connection_hdl hdl, peerState& peer, const gameFrame& frame, bool knowsLevel);
+    void flushFog(const gameFrame& frame);
+    void sendReveals(websocketpp::connection_hdl hdl, peerState& peer, const gameFrame& frame, bool knowsLevel);
+    void sendGameOver(int winner);
+    void sendSnapshot(websocketpp::connection_hdl hdl, const gameFrame& frame);
+    void sendTo(websocketpp::connection_hdl hdl, const std::string& payload,
+        websocketpp::frame::opcode::value opcode = websocketpp::frame::opcode::text);
+
+    std::string fullState(const gameFrame& frame);
+    std::string jsonRows(const endlessRows& rows) const;
+    std::string jsonLevelInfo(int chunkSize) const;
+    std::string jsonReveal(size_t from) const;
+    std::string deltaState(const gameFrame& frame) const;
+    std::string binaryLevel(const gameFrame& frame) const;
+    std::string binaryUpdate(const gameFrame& frame) const;
+
+public:
+    roomBroadcaster(server& websocketServer, roomExecutor outbox);
+
+    // Simulation side: one writer at a time (the room's strand)
+    void publishLevel(std::shared_ptr<const labyrinthMap> map, int version, bool fog = false);
+    // Fog levels: cells the player saw for the first time since the last call
+    void publishReveal(std::vector<uint32_t> cells, int version);
+    // Endless levels: rows new since the last batch, all under one version
+    void publishRows(std::shared_ptr<const endlessRows> rows, int version);
+    void publish(const gameFrame& frame);
+    void announceWinner(int playerId);
+
+    // Connection bookkeeping; each call hops onto the outbox strand
+    void addConnection(websocketpp::connection_hdl hdl);
+    void removeConnection(websocketpp::connection_hdl hdl);
+    void setFormat(websocketpp::connection_hdl hdl, wireFormat format);
+    void resync(websocketpp::connection_hdl hdl);
+
+    // Newest published frame; safe from any thread
+    gameFrame latest() const { return frames.read(); }
+};
+
+#endif // ROOMBROADCASTER_HPP
@@ -0,0 +1,77 @@
+#ifndef ROOMMANAGER_HPP
+#define ROOMMANAGER_HPP
+
+#include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/server.hpp>
+#include <asio.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.hpp"
+#include "mazePool.hpp"
+
+typedef websocketpp::server<websocketpp::config::asio> server;
+
+// Owns the WebSocket server and keys independent Game instances by room id.
+// A connection opened on "/<room>" joins that room; a bare "/" gets a private
+// room of its own. One io_context is run by a pool of threads: socket I/O and
+// decoding spread over all of them, while each room's handlers are serialized
+// on its own strand, so rooms run in parallel without locks and a single room
+// still sees its events in order. Plain HTTP GET /metrics on the same port
+// returns the metrics scrape. SIGINT and SIGTERM stop the server; the rooms
+// are destroyed once run() returns, so running matches end their recordings.
+class roomManager
+{
+private:
+    struct room
+    {
+        std::string id;
+        roomExecutor strand;
+        std::unique_ptr<Game> game;
+        int members = 0;   // Only touched under roomsMutex
+
+        explicit room(roomExecutor executor) : strand(executor) {}
+    };
+
+    asio::io_context context;
+    asio::signal_set signals;
+    mazePool mazes;
+    unsigned threadCount;
+    std::vector<std::thread> workers;
+    server websocketServer;
+
+    std::mutex roomsMutex;
+    std::map<std::string, std::shared_ptr<room>> rooms;
+    std::map<websocketpp::connection_hdl, std::shared_ptr<room>, std::owner_less<websocketpp::connection_hdl>> connectionRooms;
+    std::uint64_t nextPrivateRoom = 0;
+
+    void onOpen(websocketpp::connection_hdl hdl);
+    void onClose(websocketpp::connection_hdl hdl);
+    void onMessage(websocketpp::connection_hdl hdl, server::message_ptr msg);
+    void onHttp(websocketpp::connection_hdl hdl);
+
+    std::string roomIdFor(websocketpp::connection_hdl hdl);
+    std::shared_ptr<room> findOrCreateRoom(const std::string& roomId);
+
+public:
+    explicit roomManager(unsigned threadCount = std::thread::hardware_concurrency(), mazePoolConfig poolConfig = {});
+    ~roomManager();
+
+    roomManager(const roomManager&) = delete;
+    roomManager& operator=(const roomManager&) = delete;
+
+    // Blocks until stop() or a signal; the calling thread is one of the
+    // threadCount event-loop threads
+    void run(uint16_t port = 9002);
+    void stop();
+
+    std::size_t roomCount();
+};
+
+#endif // ROOMMANAGER_HPP
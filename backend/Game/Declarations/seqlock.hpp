@@ -0,0 +1,72 @@
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer, many-reader seqlock. The writer makes the sequence odd,
+// stores the value and makes it even again; a reader copies the value
+// between two loads of the sequence and retries if either was odd or they
+// differ. The value is kept as relaxed atomic words, so a reader racing a
+// publish sees a torn copy it then throws away, never a data race. The
+// writer never blocks; a reader only spins while a publish is in progress.
+template <typename T>
+class seqlockBuffer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "seqlockBuffer copies T with memcpy");
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence{ 0 };   // Odd while a publish is in progress
+    std::atomic<uint64_t> words[WORDS];
+
+public:
+    seqlockBuffer()
+    {
+        for (auto& word : words) word.store(0, std::memory_order_relaxed);
+    }
+
+    // Only one thread may publish at a time
+    void publish(const T& value)
+    {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint64_t start = sequence.load(std::memory_order_relaxed);
+        sequence.store(start + 1, std::memory_order_relaxed);
+        // Keeps the odd sequence ahead of every word stored below
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    T read() const
+    {
+        uint64_t buffer[WORDS];
+        uint64_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            // Keeps the word loads ahead of the second sequence load
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || after != before);
+
+        T copy;
+        std::memcpy(&copy, buffer, sizeof(T));
+        return copy;
+    }
+
+    // How many values have been published
+    uint64_t published() const { return sequence.load(std::memory_order_acquire) / 2; }
+};
+
+#endif // SEQLOCK_HPP
@@ -0,0 +1,59 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "aiController.hpp"
+#include "Difficulty.hpp"
+#include "labyrinth.hpp"
+#include "player.hpp"
+
+// AI controllers racing on one maze, with no server, strand or timer. A tick
+// moves every racer once; racers that stand on E after the same tick
+// arrived together. Nothing here reads a clock unless asked to time moves,
+// so the batch tool can run as many ticks as the CPU allows.
+class matchSimulation
+{
+public:
+    struct racer
+    {
+        Difficulty difficulty;
+        std::shared_ptr<Player> player;
+        std::unique_ptr<aiController> ai;
+        int arrivedAt = -1;      // Tick that reached E, or -1
+        uint64_t moves = 0;
+        uint64_t timedMoves = 0;
+        uint64_t timedNanos = 0;
+    };
+
+    // Every racer starts on S. HARD racers build the goal distances here.
+    // Racers' random choices derive from `seed`, so a maze and a seed replay
+    // the same race.
+    matchSimulation(labyrinthMap maze, const std::vector<Difficulty>& difficulties, uint64_t seed);
+
+    matchSimulation(const matchSimulation&) = delete;
+    matchSimulation& operator=(const matchSimulation&) = delete;
+
+    // One move per racer still running; returns how many arrived this tick.
+    // With timeMoves, each move's wall time is added to its racer.
+    int tick(bool timeMoves = false);
+
+    // Ticks until every racer has arrived or maxTicks have run; returns the
+    // first tick anyone arrived on, or -1
+    int run(int maxTicks, bool timeMoves = false);
+
+    int ticks() const { return tickCount; }
+    bool finished() const { return running == 0; }
+    const std::vector<racer>& racers() const { return field; }
+    const labyrinthMap& maze() const { return map; }
+
+private:
+    labyrinthMap map;            // Racers' controllers hold a reference; never moved
+    std::vector<racer> field;
+    int tickCount = 0;
+    int running = 0;
+};
+
+#endif // SIMULATION_HPP
@@ -0,0 +1,158 @@
+#ifndef WIREPROTOCOL_HPP
+#define WIREPROTOCOL_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "player.hpp"
+#include "labyrinth.hpp"
+#include "endlessLabyrinth.hpp"
+
+// Compact binary messages carried on WebSocket binary frames. A peer opts in
+// with "protocol":"binary" in its (JSON) config message; config stays JSON.
+// Every message starts with a one-byte type; integers are little-endian and
+// coordinates are u16.
+//
+//   MoveInput       type | playerId u8 | direction u8                      3 B
+//   PositionUpdate  type | seq u32 | positions                            14 B
+//   LevelBlob       type | level u32 | seq u32 | width u16 | height u16
+//                   | start x,y | end x,y | positions | wall bits (1 per cell,
+//                   row-major, LSB first)
+//   GameOver        type | winner u8                                       2 B
+//   Resync          type                                                   1 B
+//   RowsBlob        type | level u32 | firstRow u32 | width u16 | count u16
+//                   | wall bits (1 per cell, row-major, LSB first)
+//   LevelInfo       type | level u32 | seq u32 | width u16 | height u16
+//                   | chunk u8 | start x,y | end x,y | positions          31 B
+//   ChunkBlob       type | level u32 | cx u16 | cy u16 | wall bits of the
+//                   tile, clipped at the maze edge
+//   RevealBlob      type | level u32 | count u32 | count x (cell u32 << 1
+//                   | wall bit), cell = y * width + x | [end x,y when E is
+//                   one of the cells]
+//
+// where positions = player x,y | hasAI u8 | ai x,y. Endless levels arrive
+// as RowsBlobs instead of a LevelBlob; their y coordinates outgrow u16, so
+// positions carry y modulo 2^16 and clients unwrap it against the rows held.
+// Fog-of-war levels start with a LevelInfo whose chunk size is 0 and whose
+// end is 0xFFFF,0xFFFF; their cells, E included, arrive as RevealBlobs as
+// the player sees them.
+
+// How a connection wants state delivered; chosen by "protocol" in its config
+enum class wireFormat
+{
+    JsonFull,    // Full JSON state on every broadcast (default)
+    JsonDelta,   // Full JSON once per level, then position deltas
+    Binary,      // Level blob once per level, then position updates
+    JsonChunked, // Level header, then the tiles around the player as it moves
+    BinaryChunked
+};
+
+inline bool isBinary(wireFormat format)
+{
+    return format == wireFormat::Binary || format == wireFormat::BinaryChunked;
+}
+
+namespace wire
+{
+    enum class messageType : uint8_t
+    {
+        MoveInput = 1,
+        PositionUpdate = 2,
+        LevelBlob = 3,
+        GameOver = 4,
+        Resync = 5,
+        RowsBlob = 6,
+        LevelInfo = 7,
+        ChunkBlob = 8,
+        RevealBlob = 9
+    };
+
+    struct positions
+    {
+        uint16_t playerX = 0, playerY = 0;
+        bool hasAI = false;
+        uint16_t aiX = 0, aiY = 0;
+    };
+
+    struct moveInput
+    {
+        uint8_t playerId = 0;
+        Player::PlayerDirection direction = Player::PlayerDirection::MoveUp;
+    };
+
+    struct positionUpdate
+    {
+        uint32_t seq = 0;
+        positions pos;
+    };
+
+    struct levelBlob
+    {
+        uint32_t level = 0;
+        uint32_t seq = 0;
+        uint16_t width = 0, height = 0;
+        uint16_t startX = 0, startY = 0, endX = 0, endY = 0;
+        positions pos;
+        std::vector<std::string> rows;   // Rebuilt maze, same shape as getLabyrinth()
+    };
+
+    std::string encodeMove(int playerId, Player::PlayerDirection direction);
+    std::string encodePositionUpdate(uint32_t seq, const positions& pos);
+    std::string encodePositionUpdate(uint32_t seq, const Player* player, const Player* ai);
+    std::string encodeLevel(const labyrinthMap& map, uint32_t level, uint32_t seq, const positions& pos);
+    std::string encodeLevel(const labyrinthMap& map, uint32_t level, uint32_t seq, const Player* player, const Player* ai);
+    struct rowsBlob
+    {
+        uint32_t level = 0;
+        uint32_t firstRow = 0;
+        uint16_t width = 0;
+        std::vector<std::string> rows;   // Same shape as endlessRows::row()
+    };
+
+    struct levelInfo
+    {
+        uint32_t level = 0;
+        uint32_t seq = 0;
+        uint16_t width = 0, height = 0;
+        uint8_t chunkSize = 0;
+        uint16_t startX = 0, startY = 0, endX = 0, endY = 0;
+        positions pos;
+    };
+
+    struct chunkBlob
+    {
+        uint32_t level = 0;
+        uint16_t chunkX = 0, chunkY = 0;
+        std::vector<std::string> rows;   // The tile's part of getLabyrinth(), without S and E
+    };
+
+    struct revealBlob
+    {
+        uint32_t level = 0;
+        std::vector<uint32_t> entries;   // cell << 1 | wall
+        bool hasEnd = false;             // E was among the cells
+        uint16_t endX = 0, endY = 0;
+    };
+
+    std::string encodeReveal(uint32_t level, const labyrinthMap& map, const uint32_t* cells, size_t count);
+    std::string encodeLevelInfo(const labyrinthMap& map, uint32_t level, uint32_t seq, int chunkSize, const positions& pos);
+    std::string encodeChunk(const labyrinthMap& map, uint32_t level, int chunkX, int chunkY, int chunkSize);
+    std::string encodeRows(const endlessRows& rows, uint32_t level);
+    std::string encodeGameOver(int winner);
+    std::string encodeResync();
+
+    // Decoders return false on a short or mistyped buffer
+    bool peekType(std::string_view payload, messageType& type);
+    bool decodeMove(std::string_view payload, moveInput& out);
+    bool decodePositionUpdate(std::string_view payload, positionUpdate& out);
+    bool decodeLevel(std::string_view payload, levelBlob& out);
+    bool decodeLevelInfo(std::string_view payload, levelInfo& out);
+    bool decodeReveal(std::string_view payload, revealBlob& out);
+    // Tile sizes follow from the level, so its LevelInfo is needed
+    bool decodeChunk(std::string_view payload, const levelInfo& info, chunkBlob& out);
+    bool decodeRows(std::string_view payload, rowsBlob& out);
+    bool decodeGameOver(std::string_view payload, int& winner);
+}
+
+#endif // WIREPROTOCOL_HPP
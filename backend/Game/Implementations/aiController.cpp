@@ -1,14 +1,12 @@
 ﻿#include "../Declarations/aiController.hpp"
 #include "../Declarations/Difficulty.hpp"
+#include "../Declarations/logger.hpp"
 #include <vector>
 #include <queue>
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
-#include <iostream>
-#include <random>
-#include <atomic>
 #include <chrono>
 #include <queue>
 #include <unordered_map>
@@ -27,55 +25,68 @@ std::string directionToString(Player::PlayerDirection dir) {
     }
 }
 
-aiController::aiController(std::shared_ptr<Player> ai, labyrinthMap& gameMap, Difficulty diff)
-    : aiPlayer(ai), map(gameMap), difficulty(diff)
-{
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-}
+const int aiController::HIERARCHY_MIN_CELLS = 512 * 512;
 
-void aiController::makeMove()
+aiController::aiController(std::shared_ptr<Player> ai, labyrinthMap& gameMap, Difficulty diff, uint64_t seed)
+    : aiPlayer(ai), map(gameMap), difficulty(diff), rng(seed)
 {
-    if (!aiPlayer) return;
+    if (difficulty != Difficulty::HARD) return;
 
-    Player::PlayerDirection dir;
+    // Build the field or graph up front so the first AI turn does not pay for it
+    useHierarchy = static_cast<int64_t>(map.getWidth()) * map.getHeight() >= HIERARCHY_MIN_CELLS;
+    if (useHierarchy && !map.getHierarchy()) {
+        map.buildHierarchy();
+    }
+    else if (!useHierarchy && !map.hasGoalDistances()) {
+        map.buildGoalDistances();
+    }
+}
 
+Player::PlayerDirection aiController::chooseNextMove()
+{
     switch (difficulty) {
-    case Difficulty::EASY:
-        dir = randomMove();
-        break;
     case Difficulty::MEDIUM:
-        dir = greedyMove();
-        break;
+        return greedyMove();
     case Difficulty::HARD:
-        dir = pathfindingMove();
-        break;
+        return pathfindingMove();
+    case Difficulty::EASY:
+    default:
+        return randomMove();
     }
+}
+
+Player::PlayerDirection aiController::makeMove()
+{
+    Player::PlayerDirection dir = chooseNextMove();
 
     map.setPlayerPosition(*aiPlayer, dir);
-    std::cout << "[AI] Moved " << directionToString(dir)
-        << " to (" << aiPlayer->getX() << ", " << aiPlayer->getY() << ")\n";
+    LOG_DEBUG("[AI] Moved", { {"direction", directionToString(dir)}, {"x", aiPlayer->getX()}, {"y", aiPlayer->getY()} });
 
     if (map.gameOver(*aiPlayer)) {
-        std::cout << "[AI] Reached the goal!\n";
+        LOG_INFO("[AI] Reached the goal!");
     }
+    return dir;
 }
 
+// Uniform over the open neighbours, one draw per move
 Player::PlayerDirection aiController::randomMove()
 {
-    std::vector<Player::PlayerDirection> directions = {
+    const Player::PlayerDirection directions[] = {
         Player::PlayerDirection::MoveUp,
         Player::PlayerDirection::MoveDown,
         Player::PlayerDirection::MoveLeft,
         Player::PlayerDirection::MoveRight
     };
-    std::shuffle(directions.begin(), directions.end(), std::mt19937(std::random_device{}()));
 
+    Player::PlayerDirection open[4];
+    uint32_t count = 0;
     for (auto dir : directions) {
         if (map.isValidMove(*aiPlayer, dir))
-            return dir;
+            open[count++] = dir;
     }
 
-    return Player::PlayerDirection::MoveUp; // fallback
+    if (count == 0) return Player::PlayerDirection::MoveUp; // fallback
+    return open[rng.below(count)];
 }
 
 Player::PlayerDirection aiController::greedyMove()
@@ -118,102 +129,46 @@ Player::PlayerDirection aiController::greedyMove()
     return Player::PlayerDirection::MoveUp;
 }
 
+// Follows the level's goal distance field downhill: O(1) per step
 Player::PlayerDirection aiController::pathfindingMove()
 {
-    auto [startX, startY] = aiPlayer->getPosition();
-    auto [goalX, goalY] = map.getEndPosition();
-
-
-    struct Node {
-        int x, y, g, f;
-        bool operator>(const Node& other) const { return f > other.f; }
-    };
-
-    auto toKey = [](int x, int y) { return (x << 16) | y; };
-
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openSet;
-    std::unordered_map<int, std::pair<int, int>> cameFrom;
-    std::unordered_map<int, int> gScore;
-
-    openSet.push({ startX, startY, 0, std::abs(goalX - startX) + std::abs(goalY - startY) });
-    gScore[toKey(startX, startY)] = 0;
-
-    std::vector<std::pair<int, int>> directions = {
-        {0, -1}, {0, 1}, {-1, 0}, {1, 0}
-    };
-
-    while (!openSet.empty()) {
-        Node current = openSet.top(); openSet.pop();
-
-        if (current.x == goalX && current.y == goalY) {
-            // Reconstruct the path
-            int cx = goalX, cy = goalY;
-            int px = cx, py = cy;
-            while (cameFrom.count(toKey(cx, cy))) {
-                std::tie(px, py) = cameFrom[toKey(cx, cy)];
-                if (px == startX && py == startY) break;
-                cx = px; cy = py;
-            }
-
-            int dx = cx - startX;
-            int dy = cy - startY;
-
-            if (dx == 0 && dy == -1) return Player::PlayerDirection::MoveUp;
-            if (dx == 0 && dy == 1)  return Player::PlayerDirection::MoveDown;
-            if (dx == -1 && dy == 0) return Player::PlayerDirection::MoveLeft;
-            if (dx == 1 && dy == 0)  return Player::PlayerDirection::MoveRight;
-        }
+    if (useHierarchy) return hierarchicalMove();
+    if (!map.hasGoalDistances()) {
+        map.buildGoalDistances();
+    }
 
-        for (const auto& dirPair : directions) {
-            int dx = dirPair.first;
-            int dy = dirPair.second;
-            int nx = current.x + dx;
-            int ny = current.y + dy;
-
-            Player::PlayerDirection dir;
-            if (dx == 0 && dy == -1) dir = Player::PlayerDirection::MoveUp;
-            else if (dx == 0 && dy == 1)  dir = Player::PlayerDirection::MoveDown;
-            else if (dx == -1 && dy == 0) dir = Player::PlayerDirection::MoveLeft;
-            else if (dx == 1 && dy == 0)  dir = Player::PlayerDirection::MoveRight;
-            else continue;
-
-            if (!map.isValidMove(current.x, current.y, dir)) continue;
-
-            int tentativeG = current.g + 1;
-            int key = toKey(nx, ny);
-            if (!gScore.count(key) || tentativeG < gScore[key]) {
-                gScore[key] = tentativeG;
-                cameFrom[key] = { current.x, current.y };
-                int h = std::abs(goalX - nx) + std::abs(goalY - ny);
-                openSet.push({ nx, ny, tentativeG, tentativeG + h });
-            }
-        }
+    Player::PlayerDirection dir;
+    if (map.stepTowardGoal(aiPlayer->getX(), aiPlayer->getY(), dir)) {
+        return dir;
     }
 
     return greedyMove(); // fallback
 }
 
+// Plans again whenever the player is not where the route expects: after a
+// blocked move, a wall edit or a new level
+Player::PlayerDirection aiController::hierarchicalMove()
+{
+    if (!map.getHierarchy()) {
+        map.buildHierarchy();
+    }
 
-
-
-void aiController::runAI(std::function<bool()> isGameOver) {
-    if (!aiPlayer) return;
-
-    while (!isGameOver() && running.load()) {
-        makeMove();
-
-        if (map.gameOver(*aiPlayer)) {
-            std::cout << "[AI] Reached the goal! Game over.\n";
-
-            break; // stop the AI loop
+    int here = map.index(aiPlayer->getX(), aiPlayer->getY());
+    if (planStep >= plan.size() || plan[planStep] != here) {
+        planStep = 0;
+        int goal = map.inBounds(map.getEndX(), map.getEndY()) ? map.index(map.getEndX(), map.getEndY()) : -1;
+        if (goal < 0 || !finder.findPath(map, *map.getHierarchy(), here, goal, plan)) {
+            plan.clear();
         }
+    }
 
-        int delayMs = (4 - difficulty) * 250;
-        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+    if (planStep + 1 >= plan.size()) {
+        return greedyMove(); // fallback
     }
+    return pathFinder::directionBetween(map, here, plan[++planStep]);
 }
 
-
-void aiController::stop() {
-    running.store(false);
+std::chrono::milliseconds aiController::stepDelay() const
+{
+    return std::chrono::milliseconds((4 - difficulty) * 250);
 }
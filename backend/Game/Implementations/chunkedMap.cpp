@@ -0,0 +1,67 @@
+#include "../Declarations/chunkedMap.hpp"
+#include "../Declarations/wireProtocol.hpp"
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+const int chunkedMap::CHUNK_SIZE = 16;
+
+chunkedMap::chunkedMap(std::shared_ptr<const labyrinthMap> map, uint32_t levelVersion)
+    : level(std::move(map)), levelVersion(levelVersion),
+      columns((level->getWidth() + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      rows((level->getHeight() + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      jsonCache(static_cast<size_t>(columns) * rows), binaryCache(jsonCache.size())
+{
+}
+
+void chunkedMap::chunksAround(int x, int y, int radius, std::vector<int>& out) const
+{
+    out.clear();
+    int left = std::max(0, (x - radius) / CHUNK_SIZE);
+    int top = std::max(0, (y - radius) / CHUNK_SIZE);
+    int right = std::min(columns - 1, (x + radius) / CHUNK_SIZE);
+    int bottom = std::min(rows - 1, (y + radius) / CHUNK_SIZE);
+
+    for (int cy = top; cy <= bottom; ++cy) {
+        for (int cx = left; cx <= right; ++cx) {
+            out.push_back(cy * columns + cx);
+        }
+    }
+}
+
+const std::string& chunkedMap::json(int chunk)
+{
+    std::string& cached = jsonCache[chunk];
+    if (!cached.empty()) return cached;
+
+    int x0 = chunkX(chunk) * CHUNK_SIZE;
+    int y0 = chunkY(chunk) * CHUNK_SIZE;
+    int x1 = std::min(x0 + CHUNK_SIZE, level->getWidth());
+    int y1 = std::min(y0 + CHUNK_SIZE, level->getHeight());
+
+    nlohmann::json tileRows = nlohmann::json::array();
+    for (int y = y0; y < y1; ++y) {
+        std::string row(x1 - x0, ' ');
+        for (int x = x0; x < x1; ++x) {
+            if (x == level->getStartX() && y == level->getStartY()) row[x - x0] = 'S';
+            else if (x == level->getEndX() && y == level->getEndY()) row[x - x0] = 'E';
+            else if (level->isWall(x, y)) row[x - x0] = labyrinthMap::WALL;
+        }
+        tileRows.push_back(std::move(row));
+    }
+
+    nlohmann::json tile;
+    tile["x"] = chunkX(chunk);
+    tile["y"] = chunkY(chunk);
+    tile["rows"] = std::move(tileRows);
+    cached = tile.dump();
+    return cached;
+}
+
+const std::string& chunkedMap::binary(int chunk)
+{
+    std::string& cached = binaryCache[chunk];
+    if (cached.empty()) {
+        cached = wire::encodeChunk(*level, levelVersion, chunkX(chunk), chunkY(chunk), CHUNK_SIZE);
+    }
+    return cached;
+}
@@ -0,0 +1,152 @@
+#include "../Declarations/endlessLabyrinth.hpp"
+#include "../Declarations/labyrinth.hpp"
+#include "../Declarations/logger.hpp"
+#include "../Declarations/metrics.hpp"
+#include <algorithm>
+
+const int endlessLabyrinth::DEFAULT_WINDOW = 256;
+
+std::string endlessRows::row(int y) const
+{
+    std::string out(width, ' ');
+    for (int x = 0; x < width; ++x) {
+        if (isWall(x, y)) out[x] = labyrinthMap::WALL;
+    }
+    return out;
+}
+
+endlessLabyrinth::endlessLabyrinth(int w, uint64_t seed, int rows)
+    : width(std::max(1, (w % 2 == 0) ? w + 1 : w)), cells((width + 1) / 2),
+      window(std::max(4, rows)), wordsPerRow((width + 63) / 64),
+      ring(static_cast<size_t>(window) * wordsPerRow, ~uint64_t(0)), rng(seed),
+      sets(cells, 0), relabel(cells + 1), parent(cells + 1), members(cells + 1), chosen(cells + 1),
+      right(cells), down(cells)
+{
+    LOG_DEBUG("📦 Constructing endlessLabyrinth", { {"width", width}, {"window", window}, {"seed", seed} });
+}
+
+int endlessLabyrinth::extendTo(int row)
+{
+    if (row < end) return 0;
+
+    metrics::timer t(metrics::stage::Generate);
+    int added = 0;
+    while (end <= row && end + 2 - first <= window) {
+        carveRow();
+        added += 2;
+    }
+    return added;
+}
+
+void endlessLabyrinth::dropBefore(int row)
+{
+    first = std::clamp(row, first, end);
+}
+
+// One row of Eller's algorithm, written out as a cell row and the row of
+// links below it
+void endlessLabyrinth::carveRow()
+{
+    // Compact the labels carried down from the last row, then give every
+    // cell that was not entered from above a set of its own
+    std::fill(relabel.begin(), relabel.end(), 0);
+    uint16_t next = 0;
+    for (int i = 0; i < cells; ++i) {
+        if (sets[i] && !relabel[sets[i]]) relabel[sets[i]] = ++next;
+        sets[i] = relabel[sets[i]];
+    }
+    for (int i = 0; i < cells; ++i) {
+        if (!sets[i]) sets[i] = ++next;
+    }
+
+    // Join neighbours from different sets at random; never within a set,
+    // which would close a loop. Merges go through a union-find over the
+    // labels, so a wide row costs O(width) rather than a relabel per merge.
+    for (uint16_t s = 0; s <= next; ++s) parent[s] = s;
+    for (int i = 0; i + 1 < cells; ++i) {
+        uint16_t a = find(sets[i]);
+        uint16_t b = find(sets[i + 1]);
+        right[i] = a != b && rng.below(2);
+        if (right[i]) parent[b] = a;
+    }
+    right[cells - 1] = 0;
+    for (int i = 0; i < cells; ++i) sets[i] = find(sets[i]);
+
+    // Every set continues down through at least one cell, picked uniformly
+    // by reservoir sampling, or it would be cut off from the rows below
+    std::fill(members.begin(), members.end(), 0);
+    for (int i = 0; i < cells; ++i) {
+        uint16_t s = sets[i];
+        if (rng.below(++members[s]) == 0) chosen[s] = static_cast<uint16_t>(i);
+    }
+    for (int i = 0; i < cells; ++i) {
+        down[i] = chosen[sets[i]] == i || rng.below(3) == 0;
+    }
+
+    uint64_t* cellRow = rowWords(end);
+    uint64_t* linkRow = rowWords(end + 1);
+    std::fill(cellRow, cellRow + wordsPerRow, ~uint64_t(0));
+    std::fill(linkRow, linkRow + wordsPerRow, ~uint64_t(0));
+    for (int i = 0; i < cells; ++i) {
+        int x = 2 * i;
+        cellRow[x >> 6] &= ~(uint64_t(1) << (x & 63));
+        if (right[i]) cellRow[(x + 1) >> 6] &= ~(uint64_t(1) << ((x + 1) & 63));
+        if (down[i]) linkRow[x >> 6] &= ~(uint64_t(1) << (x & 63));
+        else sets[i] = 0;
+    }
+    end += 2;
+}
+
+uint16_t endlessLabyrinth::find(uint16_t label)
+{
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];
+        label = parent[label];
+    }
+    return label;
+}
+
+endlessRows endlessLabyrinth::copyRows(int from, int to) const
+{
+    endlessRows out;
+    out.width = width;
+    out.wordsPerRow = wordsPerRow;
+    out.keepFrom = first;
+    out.firstRow = std::clamp(from, first, end);
+    to = std::clamp(to, out.firstRow, end);
+
+    out.bits.reserve(static_cast<size_t>(to - out.firstRow) * wordsPerRow);
+    for (int y = out.firstRow; y < to; ++y) {
+        const uint64_t* words = rowWords(y);
+        out.bits.insert(out.bits.end(), words, words + wordsPerRow);
+    }
+    return out;
+}
+
+bool endlessLabyrinth::isValidMove(int fromX, int fromY, Player::PlayerDirection dir) const
+{
+    switch (dir) {
+    case Player::PlayerDirection::MoveUp:    return !isWall(fromX, fromY - 1);
+    case Player::PlayerDirection::MoveDown:  return !isWall(fromX, fromY + 1);
+    case Player::PlayerDirection::MoveLeft:  return !isWall(fromX - 1, fromY);
+    case Player::PlayerDirection::MoveRight: return !isWall(fromX + 1, fromY);
+    }
+    return false;
+}
+
+bool endlessLabyrinth::isValidMove(const Player& player, Player::PlayerDirection dir) const
+{
+    return isValidMove(player.getX(), player.getY(), dir);
+}
+
+void endlessLabyrinth::setPlayerPosition(Player& player, Player::PlayerDirection dir) const
+{
+    if (!isValidMove(player, dir)) return;
+
+    switch (dir) {
+    case Player::PlayerDirection::MoveUp:    player.setY(player.getY() - 1); break;
+    case Player::PlayerDirection::MoveDown:  player.setY(player.getY() + 1); break;
+    case Player::PlayerDirection::MoveLeft:  player.setX(player.getX() - 1); break;
+    case Player::PlayerDirection::MoveRight: player.setX(player.getX() + 1); break;
+    }
+}
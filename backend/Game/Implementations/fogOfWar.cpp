@@ -0,0 +1,42 @@
+#include "../Declarations/fogOfWar.hpp"
+
+fogOfWar::fogOfWar(const labyrinthMap& map)
+    : width(map.getWidth()), height(map.getHeight()),
+      seen((static_cast<size_t>(width) * height + 63) / 64, 0)
+{
+}
+
+void fogOfWar::see(const labyrinthMap& map, int x, int y, std::vector<uint32_t>& revealed)
+{
+    if (!map.inBounds(x, y)) return;
+    int cell = map.index(x, y);
+    uint64_t bit = uint64_t(1) << (cell & 63);
+    if (seen[cell >> 6] & bit) return;
+    seen[cell >> 6] |= bit;
+    seenCount++;
+    revealed.push_back(static_cast<uint32_t>(cell));
+}
+
+size_t fogOfWar::revealFrom(const labyrinthMap& map, int x, int y, std::vector<uint32_t>& revealed)
+{
+    size_t before = revealed.size();
+    see(map, x, y, revealed);
+
+    const int rays[4][2] = { { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+    for (const auto& [dx, dy] : rays) {
+        int cx = x;
+        int cy = y;
+        while (true) {
+            // The sides of the cell the ray is in: walls, or openings off it
+            see(map, cx + dy, cy + dx, revealed);
+            see(map, cx - dy, cy - dx, revealed);
+
+            cx += dx;
+            cy += dy;
+            if (!map.inBounds(cx, cy)) break;
+            see(map, cx, cy, revealed);
+            if (map.isWall(cx, cy)) break;
+        }
+    }
+    return revealed.size() - before;
+}
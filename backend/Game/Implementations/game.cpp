@@ -2,23 +2,39 @@
 #include "../Declarations/labyrinth.hpp"
 #include "../Declarations/player.hpp"
 #include "../Declarations/aiController.hpp"
-#include <iostream>
+#include "../Declarations/logger.hpp"
+#include "../Declarations/metrics.hpp"
 #include <cstdlib>
 #include <ctime>
-#include <thread>
 #include <websocketpp/config/asio_no_tls.hpp>
 #include <websocketpp/server.hpp>
 #include <nlohmann/json.hpp>
 
 typedef websocketpp::server<websocketpp::config::asio> server;
 
-Game::Game()
-    : isSinglePlayerMode(true), difficulty(EASY), currentLevel(0), handler(playerMap), aiThread(nullptr)
+namespace
+{
+    // Endless mode carves this far below the deepest player, in batches of
+    // the same size, and forgets rows this far above the shallowest one
+    const int ENDLESS_LOOKAHEAD = 32;
+    const int ENDLESS_TRAIL = 32;
+}
+
+Game::Game(server& websocketServer, roomExecutor executor, mazePool& mazes)
+    : isSinglePlayerMode(true), difficulty(EASY), generatorPool(executor.get_inner_executor()), mazes(mazes), currentLevel(0), handler(playerMap),
+      broadcaster(std::make_shared<roomBroadcaster>(websocketServer, asio::make_strand(executor.get_inner_executor()))),
+      aiTimer(executor)
 {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
     handler.setGame(this);
 }
 
+Game::~Game()
+{
+    // A room may be dropped mid-match; orphan any AI turn still queued
+    stopAi();
+    finishRecording();
+}
+
 void Game::setSinglePlayerMode(bool isSingle)
 {
     isSinglePlayerMode = isSingle;
@@ -34,37 +50,35 @@ void Game::setDifficulty(const std::string& input)
     else if (level == "hard") difficulty = HARD;
     else difficulty = EASY;
 
-    std::cout << "Selected difficulty: " << level << std::endl;
+    LOG_INFO("Selected difficulty", { {"difficulty", level} });
 }
 
-void Game::run()
+void Game::setDifficulty(Difficulty level)
 {
-    websockerServer.set_reuse_addr(true);
-    websockerServer.init_asio();
-
-    websockerServer.set_message_handler([this](websocketpp::connection_hdl hdl, server::message_ptr msg) {
-        std::string message = msg->get_payload();
-        handlePlayerMove(message);
-        });
-
-    websockerServer.set_open_handler([this](websocketpp::connection_hdl hdl) {
-        connections.insert(hdl);
-        });
-
-    websockerServer.set_close_handler([this](websocketpp::connection_hdl hdl) {
-        connections.erase(hdl);
-        });
+    difficulty = level;
+    LOG_INFO("Selected difficulty", { {"difficulty", level} });
+}
 
-    websockerServer.listen(9002);
-    websockerServer.start_accept();
+void Game::addConnection(websocketpp::connection_hdl hdl)
+{
+    broadcaster->addConnection(hdl);
+}
 
-    std::cout << "Server is running and ready to accept connections." << std::endl;
-    websockerServer.run();
+void Game::removeConnection(websocketpp::connection_hdl hdl)
+{
+    broadcaster->removeConnection(hdl);
 }
 
 void Game::startGame()
 {
-    if (isSinglePlayerMode)
+    matchSeed = requestedSeed ? *requestedSeed : fastRng::freshSeed();
+    rng.reseed(matchSeed);
+
+    if (isEndlessMode)
+    {
+        generateEndlessLevel();
+    }
+    else if (isSinglePlayerMode)
     {
         generateSinglePlayerLevels();
     }
@@ -77,68 +91,78 @@ void Game::startGame()
     configReceived = true;
     gameOver = false;
 
-    std::cout << "✅ Game started!" << std::endl;
+    // Recordings replay against whole mazes, which endless runs never have
+    if (recording::recorder::enabled() && !endless)
+    {
+        matchLog = std::make_unique<recording::matchLog>(recording::recorder::nextMatchId());
+        matchLog->match(isSinglePlayerMode, difficulty, matchSeed);
+    }
+
+    // 🧠 The AI may annotate the level (goal distances), so build it before
+    // the level is shared with the broadcaster
+    if (!isSinglePlayerMode && !endless)
+    {
+        ai = std::make_unique<aiController>(playerMap[2], *labyrinth, difficulty, rng.next());
+    }
+
+    LOG_INFO("✅ Game started!", { {"mode", endless ? "endless" : isSinglePlayerMode ? "single" : "local"}, {"seed", matchSeed} });
     displayLabyrinth();
+    publishLevel();
     broadcastGameState();
 
-    // 🧠 Start AI thread if multiplayer
-    if (!isSinglePlayerMode)
+    // Start AI turns if multiplayer
+    if (ai)
     {
-        ai = std::make_unique<aiController>(playerMap[2], *labyrinth, difficulty);
-
-        // Use simplified runAI with only isGameOver lambda
-        aiThread = std::make_unique<std::thread>([this]() {
-            ai->runAI([this]() {
-                return this->isGameOver();
-                });
-            });
+        aiSession = std::make_shared<int>(0);
+        scheduleAiTurn();
     }
 }
 
-
-void Game::broadcastGameState()
+// One AI move per timer tick, on the same strand as this room's messages,
+// so AI moves never race player moves or broadcasts
+void Game::scheduleAiTurn()
 {
-    if (!labyrinth)
-    {
-        std::cerr << "⚠️ Labyrinth not initialized. Cannot broadcast game state.\n";
-        return;
-    }
+    std::weak_ptr<int> session = aiSession;
 
-    nlohmann::json state;
-    state["labyrinth"] = labyrinth->getLabyrinth();
-    state["width"] = labyrinth->getWidth();
-    state["height"] = labyrinth->getHeight();
+    aiTimer.expires_after(ai->stepDelay());
+    aiTimer.async_wait([this, session](const asio::error_code& ec) {
+        // The Game may already be gone if the session expired; check before touching it
+        if (ec || session.expired()) return;
 
-    if (playerMap.count(1)) {
-        auto player = playerMap[1];
-        state["player"] = {
-            {"x", player->getX()},
-            {"y", player->getY()}
-        };
-    }
+        Player::PlayerDirection direction;
+        {
+            metrics::timer t(metrics::stage::AiStep);
+            direction = ai->makeMove();
+        }
+        if (matchLog) matchLog->move(2, direction, playerMap[2]->getX(), playerMap[2]->getY());
+        broadcastGameState();
 
-    if (playerMap.count(2)) {
-        auto aiPlayer = playerMap[2];
-        state["ai"] = {
-            {"x", aiPlayer->getX()},
-            {"y", aiPlayer->getY()}
-        };
-    }
+        if (!gameOver) {
+            scheduleAiTurn();
+        }
+        });
+}
+
+void Game::stopAi()
+{
+    aiSession.reset();
+    aiTimer.cancel();
+}
 
-    std::string payload = state.dump();
 
-    for (const auto& hdl : connections)
+void Game::broadcastGameState()
+{
+    if (!labyrinth && !endless)
     {
-        websocketpp::lib::error_code ec;
-        websockerServer.send(hdl, payload, websocketpp::frame::opcode::text, ec);
-        if (ec)
-        {
-            std::cerr << "❌ Send failed: " << ec.message() << std::endl;
-        }
+        LOG_WARN("⚠️ Labyrinth not initialized. Cannot broadcast game state.");
+        return;
     }
 
-    // ✅ Check win conditions after sending game state
-    if (gameOver) return;
+    // Serialization and sends happen on the broadcaster's strand
+    broadcaster->publish(currentFrame());
+
+    // ✅ Check win conditions after publishing game state; endless runs have no E
+    if (gameOver || endless) return;
 
     if (playerMap.count(1) && labyrinth->gameOver(*playerMap[1])) {
         broadcastWinMessage(1);
@@ -154,8 +178,8 @@ void Game::broadcastGameState()
 
 void Game::setupPlayers()
 {
-    int startX = labyrinth->getStartX();
-    int startY = labyrinth->getStartY();
+    int startX = endless ? endless->getStartX() : labyrinth->getStartX();
+    int startY = endless ? endless->getStartY() : labyrinth->getStartY();
 
     auto player = std::make_shared<Player>(1, 'P', startX, startY);
     addPlayer(1, player);
@@ -174,25 +198,80 @@ void Game::generateSinglePlayerLevels()
 {
     levels.clear();
 
+    int sizes[5];
+    uint64_t seeds[5];
     for (int i = 0; i < 5; i++) {
         int baseSize = 10;
-        int variation = std::rand() % 5 + 1;
-        int size = baseSize * difficulty + (i * 2) + variation;
+        int variation = static_cast<int>(rng.below(5)) + 1;
+        sizes[i] = baseSize * difficulty + (i * 2) + variation;
+        seeds[i] = rng.next();
+    }
 
-        labyrinthMap map(size, size);
-        map.generateLabyrinth();
-        levels.emplace_back(std::move(map));
+    // Pooled mazes where there are some. Otherwise later levels build on the
+    // thread pool while level 0 is built here and played, so the first frame
+    // doesn't wait for the whole run.
+    levels.push_back(nullptr);
+    for (int i = 1; i < 5; i++) {
+        labyrinthMap pooled;
+        if (!requestedSeed && mazes.tryAcquire(sizes[i], sizes[i], pooled)) {
+            levels.push_back(std::make_shared<pendingLevel>(std::move(pooled)));
+        }
+        else {
+            levels.push_back(pendingLevel::generateAsync(generatorPool, sizes[i], sizes[i], seeds[i]));
+        }
     }
 
-    labyrinth = std::make_unique<labyrinthMap>(std::move(levels[0]));
-    std::cout << "✅ Level generated with " << labyrinth->getLabyrinth().size() << " rows.\n";
+    labyrinth = std::make_shared<labyrinthMap>(acquireLevel(sizes[0], seeds[0]));
+    LOG_INFO("✅ Level generated", { {"rows", labyrinth->getHeight()}, {"queued", levels.size() - 1} });
 }
 
 void Game::generateMultiplayerLevel()
 {
     int size = 20;
-    labyrinth = std::make_unique<labyrinthMap>(size, size);
-	labyrinth->generateLabyrinth();
+    labyrinth = std::make_shared<labyrinthMap>(acquireLevel(size, rng.next()));
+}
+
+void Game::generateEndlessLevel()
+{
+    int width = 10 * difficulty + 1;
+    endless = std::make_unique<endlessLabyrinth>(width, rng.next());
+    endlessPublished = 0;
+    labyrinth.reset();
+}
+
+// Keeps the carved rows running ahead of the deepest player and drops the
+// ones well behind the shallowest, then hands any new rows to the
+// broadcaster. The ring never overwrites rows someone may still stand on:
+// if one player runs a whole window ahead, carving waits for the others.
+void Game::extendEndless()
+{
+    int top = 0, bottom = 0;
+    bool any = false;
+    for (const auto& [id, player] : playerMap) {
+        top = any ? std::min(top, player->getY()) : player->getY();
+        bottom = any ? std::max(bottom, player->getY()) : player->getY();
+        any = true;
+    }
+
+    endless->dropBefore(top - ENDLESS_TRAIL);
+    if (bottom + ENDLESS_LOOKAHEAD >= endless->endRow()) {
+        endless->extendTo(bottom + 2 * ENDLESS_LOOKAHEAD);
+    }
+
+    if (endless->endRow() > endlessPublished) {
+        LOG_DEBUG("Endless rows carved", { {"from", endlessPublished}, {"to", endless->endRow()}, {"dropped", endless->firstRow()} });
+        broadcaster->publishRows(std::make_shared<const endlessRows>(endless->copyRows(endlessPublished, endless->endRow())), levelVersion);
+        endlessPublished = endless->endRow();
+    }
+}
+
+labyrinthMap Game::acquireLevel(int size, uint64_t seed)
+{
+    if (!requestedSeed) return mazes.acquire(size, size);
+
+    labyrinthMap map(size, size);
+    map.generateLabyrinth(seed);
+    return map;
 }
 
 labyrinthMap& Game::getCurrentlevel()
@@ -204,54 +283,206 @@ void Game::addPlayer(int playerId, std::shared_ptr<Player> player)
 {
     handler.addPlayer(playerId, player);
     playerMap[playerId] = player;
-    std::cout << "Added player with ID " << playerId << " to Game's playerMap." << std::endl;
+    LOG_DEBUG("Added player to Game's playerMap", { {"player", playerId} });
 }
 
-void Game::handlePlayerMove(const std::string& message)
+void Game::handlePlayerMove(websocketpp::connection_hdl hdl, std::string_view message)
 {
-    std::cout << "Received message: " << message << std::endl;
+    LOG_DEBUG("Received message", { {"message", message} });
 
-    auto json = nlohmann::json::parse(message);
-
-    if (json.contains("type") && json["type"] == "config") {
-        if (gameOver || configReceived) {
-            resetGame();
-        }
-        std::string mode = json.value("mode", "single");
-        std::string diff = json.value("difficulty", "easy");
-        if (mode == "single") {
-            setSinglePlayerMode(true);   // 1 player only
-        }
-        else if (mode == "local") {
-            setSinglePlayerMode(false);  // 1 player + AI
-        }
-        else {
-            std::cerr << "⚠️ Unknown mode: " << mode << " — defaulting to single player.\n";
-            setSinglePlayerMode(true);
-        }
+    wire::inboundMessage decoded;
+    bool ok;
+    {
+        metrics::timer t(metrics::stage::Decode);
+        ok = wire::decodeText(message, decoded);
+    }
+    if (!ok) {
+        metrics::add(metrics::counter::MalformedMessages);
+        LOG_WARN("⚠️ Malformed JSON message. Ignoring.");
+        return;
+    }
+    dispatch(hdl, decoded);
+}
 
-        setDifficulty(diff);
-        startGame();
+void Game::handleBinaryMessage(websocketpp::connection_hdl hdl, std::string_view payload)
+{
+    wire::inboundMessage decoded;
+    bool ok;
+    {
+        metrics::timer t(metrics::stage::Decode);
+        ok = wire::decodeBinary(payload, decoded);
+    }
+    if (!ok) {
+        metrics::add(metrics::counter::MalformedMessages);
+        LOG_WARN("⚠️ Malformed binary message. Ignoring.", { {"bytes", payload.size()} });
         return;
     }
+    dispatch(hdl, decoded);
+}
+
+const Game::messageHandler Game::messageHandlers[] = {
+    &Game::onUnknownMessage,   // Unknown
+    &Game::onConfig,           // Config
+    &Game::onMove,             // Move
+    &Game::onResync,           // Resync
+};
+
+void Game::dispatch(websocketpp::connection_hdl hdl, const wire::inboundMessage& message)
+{
+    static_assert(sizeof(messageHandlers) / sizeof(messageHandlers[0]) ==
+        static_cast<size_t>(wire::inboundMessage::kind::Count), "one handler per message kind");
+    (this->*messageHandlers[static_cast<size_t>(message.type)])(hdl, message);
+}
+
+void Game::onUnknownMessage(websocketpp::connection_hdl, const wire::inboundMessage&)
+{
+    LOG_WARN("⚠️ Message has no recognised type or action. Ignoring.");
+}
+
+void Game::onResync(websocketpp::connection_hdl hdl, const wire::inboundMessage&)
+{
+    broadcaster->resync(hdl);
+}
+
+void Game::onConfig(websocketpp::connection_hdl hdl, const wire::inboundMessage& message)
+{
+    broadcaster->setFormat(hdl, message.protocol);
+
+    if (gameOver || configReceived) {
+        resetGame();
+    }
+
+    setEndlessMode(message.mode == wire::inboundMessage::gameMode::Endless);
+    setFogMode(message.fog && !isEndlessMode);   // Endless rows are already sent as they are carved
+    switch (message.mode) {
+    case wire::inboundMessage::gameMode::Endless:   // 1 player, no bottom
+    case wire::inboundMessage::gameMode::Single:
+        setSinglePlayerMode(true);   // 1 player only
+        break;
+    case wire::inboundMessage::gameMode::Local:
+        setSinglePlayerMode(false);  // 1 player + AI
+        break;
+    default:
+        LOG_WARN("⚠️ Unknown mode — defaulting to single player.", { {"mode", message.rawMode} });
+        setSinglePlayerMode(true);
+        break;
+    }
+
+    setDifficulty(message.difficulty);
+    setSeed(message.hasSeed ? std::optional<uint64_t>(message.seed) : std::nullopt);
+    startGame();
+}
 
+void Game::onMove(websocketpp::connection_hdl, const wire::inboundMessage& message)
+{
     if (!configReceived) {
-        std::cerr << "⚠️ Received non-config message before game was configured. Ignoring." << std::endl;
+        LOG_WARN("⚠️ Received non-config message before game was configured. Ignoring.");
         return;
     }
 
-    auto [player, action] = handler.handleWebSocketInput(message);
-    handler.updateInput(player, action);
+    if (!message.hasDirection) {
+        LOG_WARN("Invalid action. Ignoring.");
+        return;
+    }
+
+    auto it = playerMap.find(message.playerId);
+    if (it == playerMap.end()) {
+        LOG_WARN("Player ID not found.", { {"player", message.playerId} });
+        return;
+    }
+
+    applyMove(it->second, message.direction);
     broadcastGameState();
 }
 
-std::string Game::getGameState()
+void Game::applyMove(const std::shared_ptr<Player>& player, Player::PlayerDirection direction)
+{
+    int oldX = player->getX();
+    int oldY = player->getY();
+
+    // Attempt to move using labyrinth logic (checks for walls)
+    {
+        metrics::timer t(metrics::stage::Apply);
+        if (endless) endless->setPlayerPosition(*player, direction);
+        else labyrinth->setPlayerPosition(*player, direction);
+    }
+
+    int newX = player->getX();
+    int newY = player->getY();
+    if (matchLog) matchLog->move(player->getId(), direction, newX, newY);
+
+    if (oldX != newX || oldY != newY) {
+        LOG_DEBUG("✅ Player moved", { {"player", player->getId()}, {"x", newX}, {"y", newY} });
+
+        if (fog && player->getId() == 1) {
+            revealAround(*player);
+        }
+
+        if (endless) {
+            extendEndless();
+        }
+        else if (labyrinth->gameOver(*player)) {
+            LOG_INFO("🎉 Player reached the end! Game over.", { {"player", player->getId()} });
+            broadcastWinMessage(player->getId());
+        }
+    }
+    else {
+        LOG_DEBUG("⛔ Move blocked by wall", { {"player", player->getId()}, {"x", newX}, {"y", newY} });
+    }
+}
+
+// The moving parts of the match, copied out for the broadcaster
+gameFrame Game::currentFrame() const
+{
+    gameFrame frame;
+    frame.level = levelVersion;
+
+    auto player = playerMap.find(1);
+    if (player != playerMap.end()) {
+        frame.hasPlayer = true;
+        frame.playerX = player->second->getX();
+        frame.playerY = player->second->getY();
+    }
+
+    auto aiPlayer = playerMap.find(2);
+    if (aiPlayer != playerMap.end()) {
+        frame.hasAI = true;
+        frame.aiX = aiPlayer->second->getX();
+        frame.aiY = aiPlayer->second->getY();
+    }
+
+    return frame;
+}
+
+// Hands the current level to the broadcaster. The level is never modified
+// after this, so both strands can read it without locking; its junction
+// graph is built first for the same reason.
+void Game::publishLevel()
+{
+    levelVersion++;
+    if (endless) {
+        extendEndless();
+        return;
+    }
+    if (!labyrinth->getJunctionGraph()) labyrinth->buildJunctionGraph();
+    broadcaster->publishLevel(labyrinth, levelVersion, isFogMode);
+
+    fog.reset();
+    auto player = playerMap.find(1);
+    if (isFogMode && player != playerMap.end()) {
+        fog = std::make_unique<fogOfWar>(*labyrinth);
+        revealAround(*player->second);
+    }
+    if (matchLog) matchLog->level(levelVersion, *labyrinth, playerMap);
+}
+
+// Only cells seen for the first time go to the broadcaster
+void Game::revealAround(const Player& player)
 {
-    nlohmann::json json;
-    json["labyrinth"] = labyrinth->getLabyrinth();
-    json["height"] = labyrinth->getHeight();
-    json["width"] = labyrinth->getWidth();
-    return json.dump();
+    std::vector<uint32_t> cells;
+    if (fog->revealFrom(*labyrinth, player.getX(), player.getY(), cells)) {
+        broadcaster->publishReveal(std::move(cells), levelVersion);
+    }
 }
 
 bool Game::isSinglePlayer()
@@ -261,29 +492,45 @@ bool Game::isSinglePlayer()
 
 void Game::nextLevel()
 {
-    if (++currentLevel < levels.size())
+    if (++currentLevel < levels.size() && levels[currentLevel])
     {
-        labyrinth = std::make_unique<labyrinthMap>(std::move(levels[currentLevel]));
+        labyrinth = std::make_shared<labyrinthMap>(levels[currentLevel]->take());
+        levels[currentLevel].reset();
+        publishLevel();
     }
     else
     {
-        std::cout << "No more levels." << std::endl;
+        LOG_INFO("No more levels.");
     }
 }
 
 void Game::displayLabyrinth()
 {
-    std::cout << "Level " << (currentLevel + 1) << std::endl;
-    labyrinth->printLabyrinth();
-    std::cout << "Printing labyrinth" << std::endl;
+    if (endless) {
+        LOG_INFO("Endless level ready", { {"width", endless->getWidth()}, {"window", endless->getWindow()} });
+        return;
+    }
+
+    LOG_INFO("Level ready", { {"level", currentLevel + 1}, {"width", labyrinth->getWidth()}, {"height", labyrinth->getHeight()} });
+
+    // Whole-maze dumps only exist in builds with debug logging compiled in
+    if constexpr (logging::compiledIn(logging::level::Debug)) {
+        if (logging::enabled(logging::level::Debug)) {
+            for (const auto& row : labyrinth->getLabyrinth()) {
+                LOG_DEBUG("Maze row", { {"row", row} });
+            }
+        }
+    }
 }
 
 void Game::moveToNewLevel(int levelIndex)
 {
-    if (levelIndex >= 0 && levelIndex < levels.size())
+    if (levelIndex >= 0 && levelIndex < levels.size() && levels[levelIndex])
     {
-        labyrinth = std::make_unique<labyrinthMap>(std::move(levels[levelIndex]));
+        labyrinth = std::make_shared<labyrinthMap>(levels[levelIndex]->take());
+        levels[levelIndex].reset();
         currentLevel = levelIndex;
+        publishLevel();
     }
 }
 
@@ -291,45 +538,36 @@ void Game::broadcastWinMessage(int playerId)
 {
     gameOver = true;
 
-    nlohmann::json message;
-    message["type"] = "gameOver";
-    message["winner"] = playerId;
+    // Final positions first, so clients see the winning move before game over
+    broadcaster->publish(currentFrame());
+    broadcaster->announceWinner(playerId);
 
-    std::string payload = message.dump();
+    // No more AI turns once someone has won
+    stopAi();
 
-    for (const auto& hdl : connections)
-    {
-        websocketpp::lib::error_code ec;
-        websockerServer.send(hdl, payload, websocketpp::frame::opcode::text, ec);
-        if (ec)
-        {
-            std::cerr << "❌ Failed to send game over message: " << ec.message() << std::endl;
-        }
-    }
+    if (matchLog) matchLog->win(playerId);
+    finishRecording();
+}
 
-    // Clean up AI thread
-    if (aiThread && aiThread->joinable()) {
-        ai->stop();
-        aiThread->join();
-    }
+// Hands the rest of the match to the recorder's writer thread
+void Game::finishRecording()
+{
+    if (!matchLog) return;
+    matchLog->end();
+    matchLog.reset();
 }
 
 void Game::resetGame()
 {
-    std::cout << "🔄 Resetting game state..." << std::endl;
-
-    if (aiControllerPtr) {
-        aiControllerPtr->stop();  // Stop AI loop
-    }
-    if (aiThread && aiThread->joinable()) {
-        aiThread->join();         // Join thread safely
-    }
+    LOG_INFO("🔄 Resetting game state...");
 
-    aiControllerPtr.reset();
-    aiThread.reset();
-    aiAIPlayer.reset();
+    stopAi();
+    ai.reset();
+    finishRecording();
 
     labyrinth.reset();
+    endless.reset();
+    fog.reset();
     levels.clear();
     playerMap.clear();
     configReceived = false;
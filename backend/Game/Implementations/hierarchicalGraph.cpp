@@ -0,0 +1,201 @@
+#include "../Declarations/hierarchicalGraph.hpp"
+#include "../Declarations/labyrinth.hpp"
+#include <algorithm>
+
+const int hierarchicalGraph::CLUSTER_SIZE = 32;
+
+hierarchicalGraph::hierarchicalGraph(const labyrinthMap& map)
+    : width(map.getWidth()), height(map.getHeight()),
+      columns((width + CLUSTER_SIZE - 1) / CLUSTER_SIZE),
+      rows((height + CLUSTER_SIZE - 1) / CLUSTER_SIZE),
+      clusters(static_cast<size_t>(columns) * rows),
+      distances(CLUSTER_SIZE * CLUSTER_SIZE)
+{
+    for (int cy = 0; cy < rows; ++cy) {
+        for (int cx = 0; cx < columns; ++cx) {
+            int cluster = cy * columns + cx;
+            if (cx + 1 < columns) scanBorder(map, cluster, cluster + 1);
+            if (cy + 1 < rows) scanBorder(map, cluster, cluster + columns);
+        }
+    }
+    for (size_t cluster = 0; cluster < clusters.size(); ++cluster) {
+        linkCluster(map, static_cast<int>(cluster));
+    }
+}
+
+void hierarchicalGraph::clusterBounds(int cluster, int& x0, int& y0, int& x1, int& y1) const
+{
+    x0 = (cluster % columns) * CLUSTER_SIZE;
+    y0 = (cluster / columns) * CLUSTER_SIZE;
+    x1 = std::min(x0 + CLUSTER_SIZE, width);
+    y1 = std::min(y0 + CLUSTER_SIZE, height);
+}
+
+// The node at `cell`, made if there is none yet; a cell on two borders is
+// one node with two partners
+int hierarchicalGraph::addNode(int cell)
+{
+    auto found = cellNodes.find(cell);
+    if (found != cellNodes.end()) return found->second;
+
+    int id;
+    if (!freeNodes.empty()) {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        id = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    node& n = nodes[id];
+    n.cell = cell;
+    n.cluster = clusterOf(cell);
+    n.intra.clear();
+    n.inter.clear();
+    clusters[n.cluster].push_back(id);
+    cellNodes[cell] = id;
+    return id;
+}
+
+void hierarchicalGraph::removeNode(int id)
+{
+    node& n = nodes[id];
+    auto& members = clusters[n.cluster];
+    members.erase(std::find(members.begin(), members.end(), id));
+    cellNodes.erase(n.cell);
+
+    n.cell = -1;
+    n.intra.clear();
+    n.inter.clear();
+    freeNodes.push_back(id);
+}
+
+void hierarchicalGraph::unlink(int id, int partner)
+{
+    auto& links = nodes[id].inter;
+    links.erase(std::remove_if(links.begin(), links.end(),
+        [partner](const link& l) { return l.to == partner; }), links.end());
+}
+
+// Finds the entrances between `first` and the cluster to its right or below
+// it and adds a transition at the middle of each
+void hierarchicalGraph::scanBorder(const labyrinthMap& map, int first, int second)
+{
+    int x0, y0, x1, y1;
+    clusterBounds(first, x0, y0, x1, y1);
+    bool sideBySide = second == first + 1;
+    int length = sideBySide ? y1 - y0 : x1 - x0;
+
+    // The pair of cells facing each other at position i along the border
+    auto pairAt = [&](int i, int& a, int& b) {
+        if (sideBySide) {
+            a = map.index(x1 - 1, y0 + i);
+            b = a + 1;
+        }
+        else {
+            a = map.index(x0 + i, y1 - 1);
+            b = a + width;
+        }
+    };
+
+    int runStart = -1;
+    for (int i = 0; i <= length; ++i) {
+        int a = 0, b = 0;
+        bool open = false;
+        if (i < length) {
+            pairAt(i, a, b);
+            open = !map.isWall(a) && !map.isWall(b);
+        }
+
+        if (open && runStart < 0) runStart = i;
+        if (!open && runStart >= 0) {
+            pairAt((runStart + i - 1) / 2, a, b);
+            int near = addNode(a);
+            int far = addNode(b);
+            nodes[near].inter.push_back({ far, 1 });
+            nodes[far].inter.push_back({ near, 1 });
+            runStart = -1;
+        }
+    }
+}
+
+// One BFS per node, kept inside the cluster, for its distances to the rest
+void hierarchicalGraph::linkCluster(const labyrinthMap& map, int cluster)
+{
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    int span = x1 - x0;
+    auto local = [&](int cell) { return (cell / width - y0) * span + cell % width - x0; };
+
+    const auto& members = clusters[cluster];
+    for (int id : members) nodes[id].intra.clear();
+
+    for (int id : members) {
+        std::fill(distances.begin(), distances.end(), UINT32_MAX);
+        queue.clear();
+        distances[local(nodes[id].cell)] = 0;
+        queue.push_back(nodes[id].cell);
+
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int cell = queue[head];
+            int x = cell % width;
+            int y = cell / width;
+            const int neighbours[4] = {
+                y > y0 ? cell - width : -1,
+                y < y1 - 1 ? cell + width : -1,
+                x > x0 ? cell - 1 : -1,
+                x < x1 - 1 ? cell + 1 : -1
+            };
+            uint32_t next = distances[local(cell)] + 1;
+            for (int n : neighbours) {
+                if (n < 0 || map.isWall(n) || distances[local(n)] != UINT32_MAX) continue;
+                distances[local(n)] = next;
+                queue.push_back(n);
+            }
+        }
+
+        for (int other : members) {
+            uint32_t cost = distances[local(nodes[other].cell)];
+            if (other != id && cost != UINT32_MAX) nodes[id].intra.push_back({ other, cost });
+        }
+    }
+}
+
+void hierarchicalGraph::refresh(const labyrinthMap& map, int x, int y)
+{
+    int cluster = clusterAt(x, y);
+    int cx = cluster % columns;
+    int cy = cluster / columns;
+
+    // Drop the cluster's nodes and the transitions they were part of; a
+    // partner left with no other transition goes too
+    std::vector<int> old = clusters[cluster];
+    for (int id : old) {
+        for (const link& l : nodes[id].inter) {
+            unlink(l.to, id);
+            if (nodes[l.to].inter.empty()) removeNode(l.to);
+        }
+        removeNode(id);
+    }
+
+    std::vector<int> touched{ cluster };
+    if (cx > 0) {
+        scanBorder(map, cluster - 1, cluster);
+        touched.push_back(cluster - 1);
+    }
+    if (cx + 1 < columns) {
+        scanBorder(map, cluster, cluster + 1);
+        touched.push_back(cluster + 1);
+    }
+    if (cy > 0) {
+        scanBorder(map, cluster - columns, cluster);
+        touched.push_back(cluster - columns);
+    }
+    if (cy + 1 < rows) {
+        scanBorder(map, cluster, cluster + columns);
+        touched.push_back(cluster + columns);
+    }
+
+    for (int id : touched) linkCluster(map, id);
+}
@@ -0,0 +1,148 @@
+#include "../Declarations/junctionGraph.hpp"
+#include "../Declarations/labyrinth.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Open neighbours of `cell`, written to `out`; returns how many
+    int openNeighbours(const labyrinthMap& map, int cell, int out[4])
+    {
+        int width = map.getWidth();
+        int x = cell % width;
+        int y = cell / width;
+        int count = 0;
+        if (y > 0 && !map.isWall(cell - width)) out[count++] = cell - width;
+        if (y < map.getHeight() - 1 && !map.isWall(cell + width)) out[count++] = cell + width;
+        if (x > 0 && !map.isWall(cell - 1)) out[count++] = cell - 1;
+        if (x < width - 1 && !map.isWall(cell + 1)) out[count++] = cell + 1;
+        return count;
+    }
+}
+
+junctionGraph::junctionGraph(const labyrinthMap& map)
+{
+    size_t cells = static_cast<size_t>(map.getWidth()) * map.getHeight();
+    location.assign(cells, -1);
+    offsets.assign(cells, 0);
+
+    int start = map.inBounds(map.getStartX(), map.getStartY()) ? map.index(map.getStartX(), map.getStartY()) : -1;
+    int end = map.inBounds(map.getEndX(), map.getEndY()) ? map.index(map.getEndX(), map.getEndY()) : -1;
+
+    // Every cell that is not the middle of a corridor is a node
+    int around[4];
+    for (size_t cell = 0; cell < cells; ++cell) {
+        if (map.isWall(static_cast<int>(cell))) continue;
+        stats.openCells++;
+        int exits = openNeighbours(map, static_cast<int>(cell), around);
+        if (exits != 2 || static_cast<int>(cell) == start || static_cast<int>(cell) == end) {
+            addNode(static_cast<int>(cell));
+            if (exits == 1) stats.deadEnds++;
+            if (exits >= 3) stats.junctions++;
+        }
+    }
+
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        int count = openNeighbours(map, nodes[id].cell, around);
+        for (int i = 0; i < count; ++i) walkCorridor(map, static_cast<int>(id), around[i]);
+    }
+
+    // Rings of corridor with no node on them: promote one cell of each
+    for (size_t cell = 0; cell < cells; ++cell) {
+        if (location[cell] != -1 || map.isWall(static_cast<int>(cell))) continue;
+        int id = addNode(static_cast<int>(cell));
+        int count = openNeighbours(map, static_cast<int>(cell), around);
+        for (int i = 0; i < count; ++i) walkCorridor(map, id, around[i]);
+    }
+
+    linkNodes();
+
+    uint64_t total = 0;
+    for (const edge& e : edges) {
+        total += e.length;
+        stats.longestCorridor = std::max(stats.longestCorridor, e.length);
+    }
+    stats.meanCorridor = edges.empty() ? 0 : static_cast<double>(total) / edges.size();
+}
+
+int junctionGraph::addNode(int cell)
+{
+    int id = static_cast<int>(nodes.size());
+    nodes.push_back({ cell, 0, 0 });
+    location[cell] = -2 - id;
+    return id;
+}
+
+// Follows the corridor leaving node `fromNode` through `firstCell` to the
+// node at its other end. A corridor is walked once: from its other end its
+// first cell is already claimed, and a node-to-node step is only recorded
+// from the lower id.
+void junctionGraph::walkCorridor(const labyrinthMap& map, int fromNode, int firstCell)
+{
+    int reached = nodeAt(firstCell);
+    if (reached >= 0) {
+        if (fromNode < reached) {
+            edges.push_back({ fromNode, reached, 1, static_cast<uint32_t>(corridorCells.size()) });
+        }
+        return;
+    }
+    if (location[firstCell] >= 0) return;
+
+    int id = static_cast<int>(edges.size());
+    edge e{ fromNode, -1, 0, static_cast<uint32_t>(corridorCells.size()) };
+
+    int previous = nodes[fromNode].cell;
+    int cell = firstCell;
+    uint32_t steps = 1;
+    int around[4];
+    while (true) {
+        reached = nodeAt(cell);
+        if (reached >= 0) break;
+
+        location[cell] = id;
+        offsets[cell] = steps;
+        corridorCells.push_back(cell);
+
+        // Two exits, one of them the way in
+        openNeighbours(map, cell, around);
+        int next = around[0] == previous ? around[1] : around[0];
+        previous = cell;
+        cell = next;
+        steps++;
+    }
+
+    e.to = reached;
+    e.length = steps;
+    edges.push_back(e);
+}
+
+void junctionGraph::linkNodes()
+{
+    for (const edge& e : edges) {
+        if (e.from == e.to) continue;
+        nodes[e.from].degree++;
+        nodes[e.to].degree++;
+    }
+
+    uint32_t next = 0;
+    for (node& n : nodes) {
+        n.firstEdge = next;
+        next += n.degree;
+        n.degree = 0;
+    }
+
+    edgesByNode.resize(next);
+    for (size_t id = 0; id < edges.size(); ++id) {
+        const edge& e = edges[id];
+        if (e.from == e.to) continue;
+        edgesByNode[nodes[e.from].firstEdge + nodes[e.from].degree++] = static_cast<uint32_t>(id);
+        edgesByNode[nodes[e.to].firstEdge + nodes[e.to].degree++] = static_cast<uint32_t>(id);
+    }
+}
+
+int junctionGraph::cellOnEdge(int id, uint32_t steps) const
+{
+    const edge& e = edges[id];
+    if (steps == 0) return nodes[e.from].cell;
+    if (steps >= e.length) return nodes[e.to].cell;
+    return corridorCells[e.firstCell + steps - 1];
+}
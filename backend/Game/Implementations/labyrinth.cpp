@@ -3,13 +3,16 @@
 #include <string>
 #include <stack>
 #include <tuple>
-#include <random>
 #include "../Declarations/labyrinth.hpp"
+#include "../Declarations/fastRng.hpp"
+#include "../Declarations/junctionGraph.hpp"
+#include "../Declarations/hierarchicalGraph.hpp"
 #include "../Declarations/player.hpp"
-#include "../Declarations/inputHandler.hpp"
-#include "../Declarations/game.hpp"
+#include "../Declarations/logger.hpp"
+#include "../Declarations/metrics.hpp"
 
 const char labyrinthMap::WALL = '#';
+const uint32_t labyrinthMap::UNREACHABLE = UINT32_MAX;
 
 // Default constructor
 labyrinthMap::labyrinthMap() : width(0), height(0) {}
@@ -17,55 +20,117 @@ labyrinthMap::labyrinthMap() : width(0), height(0) {}
 labyrinthMap::labyrinthMap(int w, int h)
     : width((w % 2 == 0) ? w + 1 : w), height((h % 2 == 0) ? h + 1 : h)
 {
-    std::cout << "📦 Constructing labyrinthMap with w=" << width << ", h=" << height << "\n";
+    LOG_DEBUG("📦 Constructing labyrinthMap", { {"w", width}, {"h", height} });
     // DO NOT call generateLabyrinth() here unless you're certain it's safe cross-platform
 }
 
+labyrinthMap::labyrinthMap(int w, int h, int sx, int sy, int ex, int ey,
+    const uint64_t* words, std::shared_ptr<const void> backing)
+    : width(w), height(h), wallWords(words), wallBacking(std::move(backing)),
+      startX(sx), startY(sy), endX(ex), endY(ey)
+{
+}
+
+// Defined here, where hierarchicalGraph is complete
+labyrinthMap::labyrinthMap(labyrinthMap&&) noexcept = default;
+labyrinthMap& labyrinthMap::operator=(labyrinthMap&&) noexcept = default;
+labyrinthMap::~labyrinthMap() = default;
+
 void labyrinthMap::generateLabyrinth() {
-    std::cout << "🧪 generateLabyrinth() called with width=" << width << ", height=" << height << "\n";
+    generateLabyrinth(fastRng::freshSeed());
+}
+
+void labyrinthMap::generateLabyrinth(uint64_t seed) {
+    LOG_DEBUG("🧪 generateLabyrinth() called", { {"width", width}, {"height", height}, {"seed", seed} });
 
     if (width <= 0 || height <= 0) {
-        std::cerr << "❌ Invalid dimensions! Maze not generated.\n";
+        LOG_ERROR("❌ Invalid dimensions! Maze not generated.", { {"width", width}, {"height", height} });
         return;
     }
 
-    labyrinth = std::vector<std::string>(height, std::string(width, WALL));
+    metrics::timer t(metrics::stage::Generate);
+    walls.assign(getWallWordCount(), ~uint64_t(0));
+    wallWords = walls.data();
+    wallBacking.reset();
+    goalDistances.clear();
+    junctions.reset();
+    hierarchy.reset();
 
     std::stack<std::pair<int, int>> stack;
-    int startX = 0, startY = 0;
-    stack.push({ startX, startY });
-    labyrinth[startY][startX] = ' ';
+    stack.push({ 0, 0 });
+    setWall(0, 0, false);
 
-    std::vector<std::pair<int, int>> directions = { {0, -2}, {0, 2}, {-2, 0}, {2, 0} };
-    std::default_random_engine rng(std::random_device{}());
+    std::pair<int, int> directions[] = { {0, -2}, {0, 2}, {-2, 0}, {2, 0} };
+    fastRng rng(seed);
 
     while (!stack.empty()) {
         auto [x, y] = stack.top();
         stack.pop();
-        std::shuffle(directions.begin(), directions.end(), rng);
+        // Fisher-Yates by hand: std::shuffle's draws differ between standard
+        // libraries, and a seed must give the same maze everywhere
+        for (uint32_t i = 3; i > 0; --i) {
+            std::swap(directions[i], directions[rng.below(i + 1)]);
+        }
 
         for (auto [dx, dy] : directions) {
             int nx = x + dx;
             int ny = y + dy;
-            if (nx >= 0 && nx < width && ny >= 0 && ny < height && labyrinth[ny][nx] == WALL) {
-                labyrinth[ny][nx] = ' ';
-                labyrinth[y + dy / 2][x + dx / 2] = ' ';
+            if (inBounds(nx, ny) && isWall(nx, ny)) {
+                setWall(nx, ny, false);
+                setWall(x + dx / 2, y + dy / 2, false);
                 stack.push({ nx, ny });
             }
         }
     }
 
-    labyrinth[0][0] = 'S';
-    labyrinth[height / 2][width - 1] = 'E';
+    startX = 0;
+    startY = 0;
+    endX = width - 1;
+    endY = height / 2;
+    setWall(endX, endY, false);
 
     findStartTile();
 
-    std::cout << "✅ Labyrinth generation complete with " << labyrinth.size() << " rows.\n";
+    LOG_DEBUG("✅ Labyrinth generation complete", { {"rows", height} });
+}
+
+void labyrinthMap::setWall(int x, int y, bool wall) {
+    int cell = index(x, y);
+    uint64_t bit = uint64_t(1) << (cell & 63);
+    if (wall) walls[cell >> 6] |= bit;
+    else      walls[cell >> 6] &= ~bit;
+}
+
+char labyrinthMap::cellAt(int x, int y) const {
+    if (x == startX && y == startY) return 'S';
+    if (x == endX && y == endY) return 'E';
+    return isWall(x, y) ? WALL : ' ';
+}
+
+void labyrinthMap::setLabyrinthData(std::vector<std::string>&& newLab, int newW, int newH) {
+    width = newW;
+    height = newH;
+    walls.assign(getWallWordCount(), 0);
+    wallWords = walls.data();
+    wallBacking.reset();
+    goalDistances.clear();
+    junctions.reset();
+    hierarchy.reset();
+    endX = endY = -1;
+
+    for (int y = 0; y < height && y < static_cast<int>(newLab.size()); ++y) {
+        for (int x = 0; x < width && x < static_cast<int>(newLab[y].size()); ++x) {
+            char c = newLab[y][x];
+            if (c == WALL) setWall(x, y, true);
+            else if (c == 'S') { startX = x; startY = y; }
+            else if (c == 'E') { endX = x; endY = y; }
+        }
+    }
 }
 
 // Print for debugging
 void labyrinthMap::printLabyrinth() const {
-    for (const auto& row : labyrinth) {
+    for (const auto& row : getLabyrinth()) {
         std::cout << row << std::endl;
     }
 }
@@ -73,7 +138,7 @@ void labyrinthMap::printLabyrinth() const {
 // Return full JSON string of the map
 std::string labyrinthMap::getWebSocketMessageForPlayer(int playerNumber) {
     nlohmann::json message;
-    message["labyrinth"] = labyrinth;
+    message["labyrinth"] = getLabyrinth();
     message["width"] = width;
     message["height"] = height;
     return message.dump();
@@ -81,7 +146,7 @@ std::string labyrinthMap::getWebSocketMessageForPlayer(int playerNumber) {
 
 std::string labyrinthMap::serializeToJson() const {
     nlohmann::json j;
-    j["labyrinth"] = labyrinth;
+    j["labyrinth"] = getLabyrinth();
     j["width"] = width;
     j["height"] = height;
     return j.dump();
@@ -110,11 +175,11 @@ bool labyrinthMap::isValidMove(Player& player, Player::PlayerDirection direction
     case Player::PlayerDirection::MoveRight: newX++; break;
     }
 
-    return newX >= 0 && newX < width && newY >= 0 && newY < height && labyrinth[newY][newX] != WALL;
+    return inBounds(newX, newY) && !isWall(newX, newY);
 }
 
 bool labyrinthMap::gameOver(const Player& player) const {
-    return labyrinth[player.getY()][player.getX()] == 'E';
+    return player.getX() == endX && player.getY() == endY;
 }
 
 // Called when game begins
@@ -133,8 +198,14 @@ bool labyrinthMap::isEnd(const std::vector<Player>& players) const {
 }
 
 // Accessors
-const std::vector<std::string>& labyrinthMap::getLabyrinth() const {
-    return labyrinth;
+std::vector<std::string> labyrinthMap::getLabyrinth() const {
+    std::vector<std::string> rows(height, std::string(width, ' '));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            rows[y][x] = cellAt(x, y);
+        }
+    }
+    return rows;
 }
 
 int labyrinthMap::getWidth() const {
@@ -146,17 +217,12 @@ int labyrinthMap::getHeight() const {
 }
 
 void labyrinthMap::findStartTile() {
-    for (int y = 0; y < labyrinth.size(); ++y) {
-        for (int x = 0; x < labyrinth[y].size(); ++x) {
-            if (labyrinth[y][x] == 'S') {
-                startX = x;
-                startY = y;
-                std::cout << "✅ Start tile found at (" << startX << ", " << startY << ")\n";
-                return;
-            }
-        }
+    // S is stored as coordinates, so this only validates it against the grid
+    if (inBounds(startX, startY) && !isWall(startX, startY)) {
+        LOG_DEBUG("✅ Start tile found", { {"x", startX}, {"y", startY} });
+        return;
     }
-    std::cerr << "⚠️ No start tile 'S' found in labyrinth!\n";
+    LOG_WARN("⚠️ No start tile 'S' found in labyrinth!");
 }
 
 bool labyrinthMap::isValidMove(int fromX, int fromY, Player::PlayerDirection dir) const {
@@ -171,24 +237,92 @@ bool labyrinthMap::isValidMove(int fromX, int fromY, Player::PlayerDirection dir
     default: return false;
     }
 
-    // Optionally check bounds first
-    if (newX < 0 || newX >= getWidth() || newY < 0 || newY >= getHeight())
-        return false;
-
-    return labyrinth[newY][newX] != WALL;
-
+    return inBounds(newX, newY) && !isWall(newX, newY);
 }
 
 std::pair<int, int> labyrinthMap::getEndPosition() const {
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (labyrinth[y][x] == 'E') {
-                return { x, y };
-            }
-        }
+    if (endX >= 0) {
+        return { endX, endY };
     }
-    std::cerr << "⚠️ No 'E' tile found. Using fallback (width-1, height-1).\n";
+    LOG_WARN("⚠️ No 'E' tile found. Using fallback (width-1, height-1).");
     return { width - 1, height - 1 }; // fallback
 }
 
+void labyrinthMap::buildGoalDistances() {
+    goalDistances.assign(static_cast<size_t>(width) * height, UNREACHABLE);
+    if (!inBounds(endX, endY)) {
+        LOG_WARN("⚠️ No 'E' tile to build goal distances from.");
+        return;
+    }
+
+    // Plain BFS; the distance array doubles as the visited set
+    std::vector<int> queue;
+    queue.reserve(goalDistances.size());
+    int goal = index(endX, endY);
+    goalDistances[goal] = 0;
+    queue.push_back(goal);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue[head];
+        int x = cell % width;
+        int y = cell / width;
+        uint32_t next = goalDistances[cell] + 1;
+
+        const int neighbours[4][2] = { { x, y - 1 }, { x, y + 1 }, { x - 1, y }, { x + 1, y } };
+        for (const auto& [nx, ny] : neighbours) {
+            if (!inBounds(nx, ny)) continue;
+            int n = index(nx, ny);
+            if (isWall(n) || goalDistances[n] != UNREACHABLE) continue;
+            goalDistances[n] = next;
+            queue.push_back(n);
+        }
+    }
+}
 
+void labyrinthMap::buildJunctionGraph() {
+    junctions = std::make_shared<const junctionGraph>(*this);
+}
+
+void labyrinthMap::buildHierarchy() {
+    hierarchy = std::make_unique<hierarchicalGraph>(*this);
+}
+
+void labyrinthMap::editWall(int x, int y, bool wall) {
+    if (!inBounds(x, y) || isWall(x, y) == wall) return;
+
+    // A level borrowed from a mapped library is copied before its first edit
+    if (wallWords != walls.data()) {
+        walls.assign(wallWords, wallWords + getWallWordCount());
+        wallWords = walls.data();
+        wallBacking.reset();
+    }
+    setWall(x, y, wall);
+
+    goalDistances.clear();
+    junctions.reset();
+    if (hierarchy) hierarchy->refresh(*this, x, y);
+}
+
+bool labyrinthMap::stepTowardGoal(int x, int y, Player::PlayerDirection& out) const {
+    if (goalDistances.empty() || !inBounds(x, y)) return false;
+
+    const std::pair<Player::PlayerDirection, std::pair<int, int>> candidates[4] = {
+        { Player::PlayerDirection::MoveUp,    { x, y - 1 } },
+        { Player::PlayerDirection::MoveDown,  { x, y + 1 } },
+        { Player::PlayerDirection::MoveLeft,  { x - 1, y } },
+        { Player::PlayerDirection::MoveRight, { x + 1, y } }
+    };
+
+    uint32_t best = goalDistances[index(x, y)];
+    bool found = false;
+    for (const auto& [dir, pos] : candidates) {
+        if (!inBounds(pos.first, pos.second)) continue;
+        uint32_t d = goalDistances[index(pos.first, pos.second)];
+        if (d < best) {
+            best = d;
+            out = dir;
+            found = true;
+        }
+    }
+    return found;
+}
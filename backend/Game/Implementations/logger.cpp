@@ -0,0 +1,296 @@
+#include "../Declarations/logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logging
+{
+    namespace
+    {
+        const size_t RING_SIZE = 1024;     // Records per thread; power of two
+        const size_t MAX_FIELDS = 8;
+        const size_t TEXT_BYTES = 192;     // Copied text values share this
+
+        struct record
+        {
+            int64_t nanos;                 // system_clock since epoch
+            level lvl;
+            uint8_t fieldCount;
+            uint16_t textUsed;
+            const char* message;
+            struct
+            {
+                const char* key;
+                bool isText;
+                int64_t number;
+                uint16_t offset, length;
+            } fields[MAX_FIELDS];
+            char text[TEXT_BYTES];
+        };
+
+        // Written only by its owning thread, read only by whoever holds the
+        // drain lock
+        struct ring
+        {
+            record slots[RING_SIZE];
+            std::atomic<uint64_t> head{ 0 };
+            std::atomic<uint64_t> tail{ 0 };
+            std::atomic<uint64_t> dropped{ 0 };
+            unsigned thread = 0;
+        };
+
+        std::atomic<int> runtimeLevel{ LABYRINTH_LOG_LEVEL };
+        std::atomic<uint64_t> totalDropped{ 0 };
+
+        int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        const char* levelName(level lvl)
+        {
+            switch (lvl) {
+            case level::Debug: return "DEBUG";
+            case level::Info:  return "INFO ";
+            case level::Warn:  return "WARN ";
+            case level::Error: return "ERROR";
+            }
+            return "?    ";
+        }
+
+        void appendText(std::string& out, std::string_view text)
+        {
+            bool quote = text.empty() || text.find_first_of(" \"=") != std::string_view::npos;
+            if (!quote) {
+                out.append(text);
+                return;
+            }
+            out += '"';
+            for (char c : text) {
+                if (c == '"' || c == '\\') out += '\\';
+                out += c;
+            }
+            out += '"';
+        }
+
+        void appendTimestamp(std::string& out, int64_t nanos)
+        {
+            std::time_t seconds = static_cast<std::time_t>(nanos / 1000000000);
+            std::tm utc{};
+#ifdef _WIN32
+            gmtime_s(&utc, &seconds);
+#else
+            gmtime_r(&seconds, &utc);
+#endif
+            char buffer[32];
+            size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+            std::snprintf(buffer + n, sizeof(buffer) - n, ".%06dZ", static_cast<int>(nanos % 1000000000 / 1000));
+            out += buffer;
+        }
+
+        void format(std::string& out, const record& rec, unsigned thread)
+        {
+            appendTimestamp(out, rec.nanos);
+            out += ' ';
+            out += levelName(rec.lvl);
+            out += " [t";
+            out += std::to_string(thread);
+            out += "] ";
+            out += rec.message;
+
+            for (uint8_t i = 0; i < rec.fieldCount; ++i) {
+                const auto& f = rec.fields[i];
+                out += ' ';
+                out += f.key;
+                out += '=';
+                if (f.isText) appendText(out, std::string_view(rec.text + f.offset, f.length));
+                else out += std::to_string(f.number);
+            }
+            out += '\n';
+        }
+
+        class writer
+        {
+        private:
+            std::mutex ringsMutex;
+            std::vector<std::shared_ptr<ring>> rings;
+            unsigned nextThread = 0;
+
+            std::mutex drainMutex;         // One consumer at a time
+            std::string batch;
+
+            std::mutex wakeMutex;
+            std::condition_variable wake;
+            bool stopping = false;
+            std::thread worker;
+
+            // Returns whether anything was written
+            bool drain()
+            {
+                std::lock_guard<std::mutex> drainLock(drainMutex);
+
+                std::vector<std::shared_ptr<ring>> snapshot;
+                {
+                    std::lock_guard<std::mutex> lock(ringsMutex);
+                    // Rings of exited threads are released once empty
+                    rings.erase(std::remove_if(rings.begin(), rings.end(), [](const std::shared_ptr<ring>& r) {
+                        return r.use_count() == 1 && r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_relaxed);
+                        }), rings.end());
+                    snapshot = rings;
+                }
+
+                batch.clear();
+                for (const auto& r : snapshot) {
+                    uint64_t tail = r->tail.load(std::memory_order_relaxed);
+                    uint64_t head = r->head.load(std::memory_order_acquire);
+                    for (; tail != head; ++tail) {
+                        format(batch, r->slots[tail & (RING_SIZE - 1)], r->thread);
+                    }
+                    r->tail.store(tail, std::memory_order_release);
+
+                    if (uint64_t lost = r->dropped.exchange(0, std::memory_order_relaxed)) {
+                        totalDropped.fetch_add(lost, std::memory_order_relaxed);
+                        record note{};
+                        note.nanos = now();
+                        note.lvl = level::Warn;
+                        note.message = "Log ring full; records dropped";
+                        note.fieldCount = 1;
+                        note.fields[0].key = "count";
+                        note.fields[0].number = static_cast<int64_t>(lost);
+                        format(batch, note, r->thread);
+                    }
+                }
+
+                if (batch.empty()) return false;
+                std::fwrite(batch.data(), 1, batch.size(), stderr);
+                std::fflush(stderr);
+                return true;
+            }
+
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                while (!stopping) {
+                    lock.unlock();
+                    bool wrote = drain();
+                    lock.lock();
+                    if (!wrote) {
+                        wake.wait_for(lock, std::chrono::milliseconds(5));
+                    }
+                }
+            }
+
+        public:
+            writer() : worker([this] { run(); }) {}
+
+            ~writer()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(wakeMutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                worker.join();
+                drain();
+            }
+
+            std::shared_ptr<ring> attach()
+            {
+                auto r = std::make_shared<ring>();
+                std::lock_guard<std::mutex> lock(ringsMutex);
+                r->thread = nextThread++;
+                rings.push_back(r);
+                return r;
+            }
+
+            void flush() { drain(); }
+        };
+
+        writer& sink()
+        {
+            static writer instance;
+            return instance;
+        }
+
+        ring& localRing()
+        {
+            // The registration lock is only taken on a thread's first record
+            thread_local std::shared_ptr<ring> local = sink().attach();
+            return *local;
+        }
+    }
+
+    void setLevel(level lvl)
+    {
+        runtimeLevel.store(std::max(static_cast<int>(lvl), LABYRINTH_LOG_LEVEL), std::memory_order_relaxed);
+    }
+
+    bool enabled(level lvl)
+    {
+        return static_cast<int>(lvl) >= runtimeLevel.load(std::memory_order_relaxed);
+    }
+
+    bool parseLevel(std::string_view name, level& out)
+    {
+        if (name == "debug") out = level::Debug;
+        else if (name == "info") out = level::Info;
+        else if (name == "warn") out = level::Warn;
+        else if (name == "error") out = level::Error;
+        else return false;
+        return true;
+    }
+
+    void write(level lvl, const char* message, std::initializer_list<field> fields)
+    {
+        ring& r = localRing();
+
+        uint64_t head = r.head.load(std::memory_order_relaxed);
+        if (head - r.tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        record& rec = r.slots[head & (RING_SIZE - 1)];
+        rec.nanos = now();
+        rec.lvl = lvl;
+        rec.message = message;
+        rec.fieldCount = 0;
+        rec.textUsed = 0;
+
+        for (const field& f : fields) {
+            if (rec.fieldCount == MAX_FIELDS) break;
+            auto& slot = rec.fields[rec.fieldCount++];
+            slot.key = f.key;
+            slot.isText = f.isText;
+            slot.number = f.number;
+            if (f.isText) {
+                size_t length = std::min(f.text.size(), TEXT_BYTES - rec.textUsed);
+                std::memcpy(rec.text + rec.textUsed, f.text.data(), length);
+                slot.offset = rec.textUsed;
+                slot.length = static_cast<uint16_t>(length);
+                rec.textUsed += static_cast<uint16_t>(length);
+            }
+        }
+
+        r.head.store(head + 1, std::memory_order_release);
+    }
+
+    void flush()
+    {
+        sink().flush();
+    }
+
+    uint64_t droppedCount()
+    {
+        return totalDropped.load(std::memory_order_relaxed);
+    }
+}
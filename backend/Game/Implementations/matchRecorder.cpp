@@ -0,0 +1,400 @@
+#include "../Declarations/matchRecorder.hpp"
+#include "../Declarations/logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+namespace recording
+{
+    namespace
+    {
+        const char MAGIC[4] = { 'L', 'B', 'M', 'R' };
+        const uint16_t VERSION = 2;           // 2 added the match seed
+        const uint16_t OLDEST_VERSION = 1;
+        const size_t HEADER_SIZE = 8;
+        const size_t HANDOFF_BYTES = 16 * 1024;        // A long match is handed over in pieces this big
+        const size_t QUEUE_BUDGET = 8 * 1024 * 1024;   // Bytes waiting for the writer before chunks drop
+
+        void putVarint(std::string& out, uint64_t value)
+        {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        int64_t steadyMicros()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        class writer
+        {
+        private:
+            std::FILE* file;
+
+            std::mutex queueMutex;
+            std::condition_variable wake;
+            std::string queued;            // Framed chunks, in submission order
+            bool stopping = false;
+            std::thread worker;
+
+            void run()
+            {
+                std::string batch;
+                std::unique_lock<std::mutex> lock(queueMutex);
+                while (true) {
+                    wake.wait(lock, [this] { return stopping || !queued.empty(); });
+                    batch.swap(queued);
+                    bool last = stopping;
+                    lock.unlock();
+
+                    if (!batch.empty()) {
+                        std::fwrite(batch.data(), 1, batch.size(), file);
+                        std::fflush(file);
+                        batch.clear();
+                    }
+
+                    lock.lock();
+                    if (last && queued.empty()) return;
+                }
+            }
+
+        public:
+            std::atomic<uint64_t> dropped{ 0 };
+            std::atomic<uint64_t> nextId{ 1 };
+
+            explicit writer(std::FILE* file) : file(file), worker([this] { run(); }) {}
+
+            ~writer()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                worker.join();
+                std::fclose(file);
+            }
+
+            bool submit(uint64_t matchId, const std::string& events)
+            {
+                bool accepted = true;
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    accepted = queued.size() + events.size() <= QUEUE_BUDGET;
+                    putVarint(queued, matchId);
+                    if (accepted) {
+                        putVarint(queued, events.size());
+                        queued += events;
+                    }
+                    else {
+                        // A few bytes over budget, so the reader knows the match has a gap
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        putVarint(queued, 0);
+                    }
+                }
+                wake.notify_one();
+                return accepted;
+            }
+        };
+
+        std::mutex sinkMutex;              // Guards open/close against submits
+        std::unique_ptr<writer> sink;
+        std::atomic<bool> active{ false };
+    }
+
+    bool recorder::open(const std::string& path)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "a+b");
+        if (!file) {
+            LOG_ERROR("❌ Could not open match recording", { {"path", path} });
+            return false;
+        }
+
+        // Append-only: a new file gets the header, an existing one keeps
+        // growing if it was written with this version
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        if (size > 0) {
+            char header[HEADER_SIZE] = {};
+            uint16_t version = 0;
+            std::fseek(file, 0, SEEK_SET);
+            bool readable = std::fread(header, 1, sizeof(header), file) == sizeof(header);
+            std::memcpy(&version, header + 4, sizeof(version));
+            if (!readable || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+                LOG_ERROR("❌ Match recording has another format; not appending to it",
+                    { {"path", path}, {"version", version}, {"expected", VERSION} });
+                std::fclose(file);
+                return false;
+            }
+            std::fseek(file, 0, SEEK_END);
+        }
+        else {
+            char header[HEADER_SIZE] = {};
+            std::memcpy(header, MAGIC, sizeof(MAGIC));
+            std::memcpy(header + 4, &VERSION, sizeof(VERSION));
+            std::fwrite(header, 1, sizeof(header), file);
+        }
+
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        sink = std::make_unique<writer>(file);
+        // Ids only need to be unique within a file; start past earlier runs
+        sink->nextId.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()), std::memory_order_relaxed);
+        active.store(true, std::memory_order_release);
+        LOG_INFO("🎞️ Recording matches", { {"path", path} });
+        return true;
+    }
+
+    bool recorder::enabled()
+    {
+        return active.load(std::memory_order_acquire);
+    }
+
+    uint64_t recorder::nextMatchId()
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        return sink ? sink->nextId.fetch_add(1, std::memory_order_relaxed) : 0;
+    }
+
+    bool recorder::submit(uint64_t matchId, const std::string& events)
+    {
+        if (events.empty()) return true;
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        return sink && sink->submit(matchId, events);
+    }
+
+    void recorder::close()
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        active.store(false, std::memory_order_release);
+        if (sink && sink->dropped.load(std::memory_order_relaxed) > 0) {
+            LOG_WARN("⚠️ Match recording dropped chunks", { {"count", sink->dropped.load(std::memory_order_relaxed)} });
+        }
+        sink.reset();
+    }
+
+    uint64_t recorder::droppedChunks()
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        return sink ? sink->dropped.load(std::memory_order_relaxed) : 0;
+    }
+
+    matchLog::matchLog(uint64_t id) : id(id), lastMicros(steadyMicros())
+    {
+    }
+
+    void matchLog::begin(eventType type)
+    {
+        int64_t now = steadyMicros();
+        buffer.push_back(static_cast<char>(type));
+        putVarint(buffer, static_cast<uint64_t>(now > lastMicros ? now - lastMicros : 0));
+        lastMicros = now;
+    }
+
+    void matchLog::handOff()
+    {
+        if (!dropped && !recorder::submit(id, buffer)) dropped = true;
+        buffer.clear();
+    }
+
+    void matchLog::match(bool singlePlayer, int difficulty, uint64_t seed)
+    {
+        begin(eventType::Match);
+        putVarint(buffer, singlePlayer ? 0 : 1);
+        putVarint(buffer, static_cast<uint64_t>(difficulty));
+        putVarint(buffer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()));
+        putVarint(buffer, seed);
+    }
+
+    void matchLog::level(int version, const labyrinthMap& map, const std::map<int, std::shared_ptr<Player>>& players)
+    {
+        auto [endX, endY] = map.getEndPosition();
+
+        begin(eventType::Level);
+        putVarint(buffer, static_cast<uint64_t>(version));
+        putVarint(buffer, static_cast<uint64_t>(map.getWidth()));
+        putVarint(buffer, static_cast<uint64_t>(map.getHeight()));
+        putVarint(buffer, static_cast<uint64_t>(map.getStartX()));
+        putVarint(buffer, static_cast<uint64_t>(map.getStartY()));
+        putVarint(buffer, static_cast<uint64_t>(endX));
+        putVarint(buffer, static_cast<uint64_t>(endY));
+        putVarint(buffer, players.size());
+        for (const auto& [playerId, player] : players) {
+            putVarint(buffer, static_cast<uint64_t>(playerId));
+            putVarint(buffer, static_cast<uint64_t>(player->getX()));
+            putVarint(buffer, static_cast<uint64_t>(player->getY()));
+        }
+        buffer.append(reinterpret_cast<const char*>(map.getWallBits()), map.getWallWordCount() * sizeof(uint64_t));
+
+        if (buffer.size() >= HANDOFF_BYTES) handOff();
+    }
+
+    void matchLog::move(int playerId, Player::PlayerDirection direction, int x, int y)
+    {
+        begin(eventType::Move);
+        putVarint(buffer, static_cast<uint64_t>(playerId));
+        putVarint(buffer, static_cast<uint64_t>(direction));
+        putVarint(buffer, static_cast<uint64_t>(x));
+        putVarint(buffer, static_cast<uint64_t>(y));
+
+        if (buffer.size() >= HANDOFF_BYTES) handOff();
+    }
+
+    void matchLog::win(int playerId)
+    {
+        begin(eventType::Win);
+        putVarint(buffer, static_cast<uint64_t>(playerId));
+    }
+
+    void matchLog::end()
+    {
+        begin(eventType::End);
+        handOff();
+    }
+
+    bool readFile(const std::string& path, std::map<uint64_t, std::string>& matches, uint16_t& version,
+        std::set<uint64_t>& dropped)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            LOG_ERROR("❌ Match recording not found", { {"path", path} });
+            return false;
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        version = 0;
+        if (data.size() >= HEADER_SIZE) std::memcpy(&version, data.data() + 4, sizeof(version));
+        if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0 ||
+            version < OLDEST_VERSION || version > VERSION) {
+            LOG_ERROR("❌ Not a match recording", { {"path", path} });
+            return false;
+        }
+
+        // Chunk framing uses the same varints as the events
+        size_t at = HEADER_SIZE;
+        auto varint = [&](uint64_t& out) {
+            out = 0;
+            for (int shift = 0; shift < 64 && at < data.size(); shift += 7) {
+                uint8_t byte = static_cast<uint8_t>(data[at++]);
+                out |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        };
+
+        while (at < data.size()) {
+            uint64_t matchId, length;
+            if (!varint(matchId) || !varint(length) || length > data.size() - at) {
+                // A crash can leave a torn last chunk; keep what came before it
+                LOG_WARN("⚠️ Match recording ends in a partial chunk", { {"path", path}, {"offset", at} });
+                break;
+            }
+            if (length == 0) dropped.insert(matchId);
+            else matches[matchId].append(data, at, static_cast<size_t>(length));
+            at += static_cast<size_t>(length);
+        }
+
+        for (uint64_t matchId : dropped) matches.erase(matchId);
+        if (!dropped.empty()) {
+            LOG_WARN("⚠️ Match recording has matches with dropped chunks", { {"path", path}, {"count", dropped.size()} });
+        }
+        return true;
+    }
+
+    bool eventReader::varint(uint64_t& out)
+    {
+        out = 0;
+        for (int shift = 0; shift < 64 && at < data.size(); shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(data[at++]);
+            out |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        bad = true;
+        return false;
+    }
+
+    bool eventReader::number(int& out)
+    {
+        uint64_t value;
+        if (!varint(value) || value > 0x7fffffff) {
+            bad = true;
+            return false;
+        }
+        out = static_cast<int>(value);
+        return true;
+    }
+
+    bool eventReader::next(matchEvent& out)
+    {
+        if (bad || at >= data.size()) return false;
+
+        uint8_t type = static_cast<uint8_t>(data[at++]);
+        uint64_t delta;
+        if (!varint(delta)) return false;
+        clock += delta;
+        out.type = static_cast<eventType>(type);
+        out.micros = clock;
+
+        switch (out.type) {
+        case eventType::Match:
+            out.seed = 0;
+            return number(out.mode) && number(out.difficulty) && varint(out.wallMicros) &&
+                (version < 2 || varint(out.seed));
+
+        case eventType::Level: {
+            int count;
+            if (!number(out.level) || !number(out.width) || !number(out.height) ||
+                !number(out.startX) || !number(out.startY) || !number(out.endX) || !number(out.endY) ||
+                !number(count)) return false;
+
+            out.players.clear();
+            for (int i = 0; i < count; ++i) {
+                playerPosition p;
+                if (!number(p.id) || !number(p.x) || !number(p.y)) return false;
+                out.players.push_back(p);
+            }
+
+            size_t words = (static_cast<size_t>(out.width) * out.height + 63) / 64;
+            if (words > (data.size() - at) / sizeof(uint64_t)) {
+                bad = true;
+                return false;
+            }
+            out.walls.resize(words);
+            std::memcpy(out.walls.data(), data.data() + at, words * sizeof(uint64_t));
+            at += words * sizeof(uint64_t);
+            return true;
+        }
+
+        case eventType::Move: {
+            int direction;
+            if (!number(out.playerId) || !number(direction) || !number(out.x) || !number(out.y)) return false;
+            if (direction > static_cast<int>(Player::PlayerDirection::MoveDown)) {
+                bad = true;
+                return false;
+            }
+            out.direction = static_cast<Player::PlayerDirection>(direction);
+            return true;
+        }
+
+        case eventType::Win:
+            return number(out.playerId);
+
+        case eventType::End:
+            return true;
+        }
+
+        bad = true;
+        return false;
+    }
+}
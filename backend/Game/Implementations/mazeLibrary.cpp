@@ -0,0 +1,225 @@
+#include "../Declarations/mazeLibrary.hpp"
+#include "../Declarations/logger.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char MAGIC[4] = { 'L', 'B', 'M', 'L' };
+    const size_t HEADER_SIZE = 32;
+    const size_t ENTRY_SIZE = 32;
+
+    // The grids are used in place, so the host must share the file's byte order
+    bool littleEndianHost()
+    {
+        const uint16_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    template <typename T>
+    T get(const unsigned char* at)
+    {
+        T value;
+        std::memcpy(&value, at, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void put(std::string& out, T value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    int normalized(int size)
+    {
+        return (size % 2 == 0) ? size + 1 : size;
+    }
+}
+
+std::shared_ptr<mazeLibrary> mazeLibrary::open(const std::string& path)
+{
+    if (!littleEndianHost()) {
+        LOG_ERROR("❌ Maze library needs a little-endian host", { {"path", path} });
+        return nullptr;
+    }
+
+    std::shared_ptr<mazeLibrary> library(new mazeLibrary());
+    if (!library->load(path) || !library->parse()) return nullptr;
+
+    LOG_INFO("📚 Maze library mapped", { {"path", path}, {"mazes", library->entries.size()},
+        {"sizes", library->bySize.size()}, {"bytes", library->length} });
+    return library;
+}
+
+mazeLibrary::~mazeLibrary()
+{
+#ifndef _WIN32
+    if (data && fallback.empty()) {
+        munmap(const_cast<unsigned char*>(data), length);
+    }
+#endif
+}
+
+bool mazeLibrary::load(const std::string& path)
+{
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_WARN("⚠️ Maze library not found", { {"path", path} });
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        LOG_WARN("⚠️ Maze library is empty or unreadable", { {"path", path} });
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_WARN("⚠️ Could not map maze library", { {"path", path} });
+        return false;
+    }
+
+    data = static_cast<const unsigned char*>(mapped);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        LOG_WARN("⚠️ Maze library not found", { {"path", path} });
+        return false;
+    }
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = fallback.data();
+    length = fallback.size();
+    return length > 0;
+#endif
+}
+
+bool mazeLibrary::parse()
+{
+    if (length < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        LOG_ERROR("❌ Not a maze library");
+        return false;
+    }
+
+    uint16_t version = get<uint16_t>(data + 4);
+    uint16_t headerSize = get<uint16_t>(data + 6);
+    uint32_t count = get<uint32_t>(data + 8);
+    uint32_t entrySize = get<uint32_t>(data + 12);
+    uint64_t indexOffset = get<uint64_t>(data + 16);
+
+    if (version != VERSION) {
+        LOG_ERROR("❌ Unsupported maze library version", { {"version", version}, {"expected", VERSION} });
+        return false;
+    }
+    if (headerSize < HEADER_SIZE || entrySize < ENTRY_SIZE || indexOffset > length ||
+        (length - indexOffset) / entrySize < count) {
+        LOG_ERROR("❌ Maze library index is truncated");
+        return false;
+    }
+
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const unsigned char* at = data + indexOffset + static_cast<size_t>(i) * entrySize;
+        entry e;
+        e.width = get<uint16_t>(at + 0);
+        e.height = get<uint16_t>(at + 2);
+        e.startX = get<uint16_t>(at + 4);
+        e.startY = get<uint16_t>(at + 6);
+        e.endX = get<uint16_t>(at + 8);
+        e.endY = get<uint16_t>(at + 10);
+        e.shortestPath = get<uint32_t>(at + 12);
+        e.gridOffset = get<uint64_t>(at + 16);
+        e.gridWords = get<uint32_t>(at + 24);
+
+        size_t needed = (static_cast<size_t>(e.width) * e.height + 63) / 64;
+        bool fits = e.gridOffset % 8 == 0 && e.gridOffset <= length &&
+            (length - e.gridOffset) / 8 >= e.gridWords;
+        if (e.width == 0 || e.height == 0 || e.gridWords != needed || !fits ||
+            e.startX >= e.width || e.startY >= e.height || e.endX >= e.width || e.endY >= e.height) {
+            LOG_ERROR("❌ Maze library entry is corrupt", { {"entry", i} });
+            return false;
+        }
+
+        bySize[{ e.width, e.height }].entries.push_back(i);
+        entries.push_back(e);
+    }
+    return true;
+}
+
+bool mazeLibrary::take(int width, int height, labyrinthMap& out)
+{
+    auto it = bySize.find({ normalized(width), normalized(height) });
+    if (it == bySize.end()) return false;
+
+    sizeBucket& bucket = it->second;
+    uint32_t pick = bucket.entries[bucket.next.fetch_add(1, std::memory_order_relaxed) % bucket.entries.size()];
+    const entry& e = entries[pick];
+
+    // Aliasing pointer: the grid shares ownership of the whole library
+    std::shared_ptr<const void> backing(shared_from_this(), data + e.gridOffset);
+    out = labyrinthMap(e.width, e.height, e.startX, e.startY, e.endX, e.endY,
+        reinterpret_cast<const uint64_t*>(data + e.gridOffset), std::move(backing));
+    return true;
+}
+
+bool mazeLibrary::write(const std::string& path, const std::vector<labyrinthMap>& mazes)
+{
+    if (!littleEndianHost()) {
+        LOG_ERROR("❌ Maze library needs a little-endian host", { {"path", path} });
+        return false;
+    }
+
+    const uint64_t indexOffset = HEADER_SIZE;
+    uint64_t gridOffset = indexOffset + mazes.size() * ENTRY_SIZE;
+
+    std::string header, index, grids;
+    header.append(MAGIC, sizeof(MAGIC));
+    put<uint16_t>(header, VERSION);
+    put<uint16_t>(header, static_cast<uint16_t>(HEADER_SIZE));
+    put<uint32_t>(header, static_cast<uint32_t>(mazes.size()));
+    put<uint32_t>(header, static_cast<uint32_t>(ENTRY_SIZE));
+    put<uint64_t>(header, indexOffset);
+    put<uint64_t>(header, 0);
+
+    for (const labyrinthMap& map : mazes) {
+        auto [endX, endY] = map.getEndPosition();
+        uint32_t shortest = map.hasGoalDistances() ? map.goalDistance(map.getStartX(), map.getStartY()) : labyrinthMap::UNREACHABLE;
+        size_t words = map.getWallWordCount();
+
+        put<uint16_t>(index, static_cast<uint16_t>(map.getWidth()));
+        put<uint16_t>(index, static_cast<uint16_t>(map.getHeight()));
+        put<uint16_t>(index, static_cast<uint16_t>(map.getStartX()));
+        put<uint16_t>(index, static_cast<uint16_t>(map.getStartY()));
+        put<uint16_t>(index, static_cast<uint16_t>(endX));
+        put<uint16_t>(index, static_cast<uint16_t>(endY));
+        put<uint32_t>(index, shortest);
+        put<uint64_t>(index, gridOffset + grids.size());
+        put<uint32_t>(index, static_cast<uint32_t>(words));
+        put<uint32_t>(index, 0);
+
+        grids.append(reinterpret_cast<const char*>(map.getWallBits()), words * sizeof(uint64_t));
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << header << index << grids;
+    if (!file) {
+        LOG_ERROR("❌ Could not write maze library", { {"path", path} });
+        return false;
+    }
+    return true;
+}
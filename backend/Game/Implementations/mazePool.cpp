@@ -0,0 +1,97 @@
+#include "../Declarations/mazePool.hpp"
+#include "../Declarations/logger.hpp"
+
+mazePool::mazePool(asio::io_context::executor_type pool, mazePoolConfig settings)
+    : pool(pool), settings(settings)
+{
+    if (this->settings.highWater < this->settings.lowWater) {
+        this->settings.highWater = this->settings.lowWater;
+    }
+    if (!this->settings.libraryPath.empty()) {
+        library = mazeLibrary::open(this->settings.libraryPath);
+    }
+}
+
+bool mazePool::tryAcquire(int width, int height, labyrinthMap& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    bucket& b = bucketFor(width, height);
+
+    bool hit = !b.ready.empty();
+    if (hit) {
+        out = std::move(b.ready.back());
+        b.ready.pop_back();
+        hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (library && library->take(width, height, out)) {
+        hit = true;
+        libraryHits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        LOG_DEBUG("Maze pool miss", { {"width", width}, {"height", height} });
+    }
+
+    if (b.ready.size() < settings.lowWater) {
+        scheduleRefill(width, height, b);
+    }
+    return hit;
+}
+
+labyrinthMap mazePool::acquire(int width, int height)
+{
+    labyrinthMap map;
+    if (!tryAcquire(width, height, map)) {
+        map = labyrinthMap(width, height);
+        map.generateLabyrinth();
+    }
+    return map;
+}
+
+mazePool::stats mazePool::snapshot()
+{
+    stats s;
+    s.hits = hits.load(std::memory_order_relaxed);
+    s.libraryHits = libraryHits.load(std::memory_order_relaxed);
+    s.misses = misses.load(std::memory_order_relaxed);
+    s.generated = generated.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& [key, b] : buckets) {
+        s.ready += b.ready.size();
+    }
+    return s;
+}
+
+// labyrinthMap rounds even sizes up to odd ones, so 14 and 15 share a bucket
+mazePool::bucket& mazePool::bucketFor(int width, int height)
+{
+    auto odd = [](int size) { return (size % 2 == 0) ? size + 1 : size; };
+    return buckets[{ odd(width), odd(height) }];
+}
+
+void mazePool::scheduleRefill(int width, int height, bucket& b)
+{
+    if (b.refilling || settings.highWater == 0) return;
+    b.refilling = true;
+    asio::post(pool, [this, width, height]() { refillOne(width, height); });
+}
+
+// Builds one maze outside the lock, then queues the next if still short
+void mazePool::refillOne(int width, int height)
+{
+    labyrinthMap map(width, height);
+    map.generateLabyrinth();
+    generated.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    bucket& b = bucketFor(width, height);
+    b.ready.push_back(std::move(map));
+
+    if (b.ready.size() < settings.highWater) {
+        asio::post(pool, [this, width, height]() { refillOne(width, height); });
+    }
+    else {
+        b.refilling = false;
+    }
+}
@@ -0,0 +1,244 @@
+#include "../Declarations/messageDecoder.hpp"
+#include <cctype>
+#include <climits>
+
+namespace
+{
+    struct cursor
+    {
+        const char* p;
+        const char* end;
+
+        bool done() const { return p >= end; }
+        char peek() const { return *p; }
+    };
+
+    void skipWhitespace(cursor& c)
+    {
+        while (!c.done() && (c.peek() == ' ' || c.peek() == '\t' || c.peek() == '\n' || c.peek() == '\r')) ++c.p;
+    }
+
+    bool expect(cursor& c, char ch)
+    {
+        skipWhitespace(c);
+        if (c.done() || c.peek() != ch) return false;
+        ++c.p;
+        return true;
+    }
+
+    // Raw string contents between the quotes; escapes are skipped, not decoded
+    bool parseString(cursor& c, std::string_view& out)
+    {
+        if (!expect(c, '"')) return false;
+        const char* begin = c.p;
+        while (!c.done() && c.peek() != '"') {
+            if (c.peek() == '\\') ++c.p;
+            ++c.p;
+        }
+        if (c.done()) return false;
+        out = std::string_view(begin, static_cast<size_t>(c.p - begin));
+        ++c.p;
+        return true;
+    }
+
+    bool parseInt(cursor& c, int& out)
+    {
+        skipWhitespace(c);
+        bool negative = (!c.done() && c.peek() == '-');
+        if (negative) ++c.p;
+        if (c.done() || !std::isdigit(static_cast<unsigned char>(c.peek()))) return false;
+
+        int value = 0;
+        while (!c.done() && std::isdigit(static_cast<unsigned char>(c.peek()))) {
+            int digit = c.peek() - '0';
+            if (value > (INT_MAX - digit) / 10) return false;
+            value = value * 10 + digit;
+            ++c.p;
+        }
+        // 1.0 or 1e3 is not an integer id
+        if (!c.done() && (c.peek() == '.' || c.peek() == 'e' || c.peek() == 'E')) return false;
+        out = negative ? -value : value;
+        return true;
+    }
+
+    // Decimal digits only; false on overflow or anything else
+    bool parseUnsigned(std::string_view digits, uint64_t& out)
+    {
+        if (digits.empty()) return false;
+        uint64_t value = 0;
+        for (char ch : digits) {
+            if (!std::isdigit(static_cast<unsigned char>(ch))) return false;
+            uint64_t digit = static_cast<uint64_t>(ch - '0');
+            if (value > (UINT64_MAX - digit) / 10) return false;
+            value = value * 10 + digit;
+        }
+        out = value;
+        return true;
+    }
+
+    // Skips any JSON value, including nested objects and arrays
+    bool skipValue(cursor& c)
+    {
+        skipWhitespace(c);
+        if (c.done()) return false;
+
+        if (c.peek() == '"') {
+            std::string_view ignored;
+            return parseString(c, ignored);
+        }
+
+        if (c.peek() == '{' || c.peek() == '[') {
+            int depth = 0;
+            while (!c.done()) {
+                char ch = c.peek();
+                if (ch == '"') {
+                    std::string_view ignored;
+                    if (!parseString(c, ignored)) return false;
+                    continue;
+                }
+                if (ch == '{' || ch == '[') depth++;
+                else if (ch == '}' || ch == ']') depth--;
+                ++c.p;
+                if (depth == 0) return true;
+            }
+            return false;
+        }
+
+        // Number, true, false or null
+        const char* begin = c.p;
+        while (!c.done() && c.peek() != ',' && c.peek() != '}' && c.peek() != ']'
+            && c.peek() != ' ' && c.peek() != '\t' && c.peek() != '\n' && c.peek() != '\r') ++c.p;
+        return c.p != begin;
+    }
+
+    bool equalsIgnoreCase(std::string_view text, std::string_view lower)
+    {
+        if (text.size() != lower.size()) return false;
+        for (size_t i = 0; i < lower.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(text[i])) != lower[i]) return false;
+        }
+        return true;
+    }
+
+    // "MoveUp", "moveup", "up", "w" ... -> direction
+    bool parseAction(std::string_view action, Player::PlayerDirection& out)
+    {
+        if (action.size() > 4 && equalsIgnoreCase(action.substr(0, 4), "move")) {
+            action.remove_prefix(4);
+        }
+        return Player::tryParseDirection(action, out);
+    }
+
+    Difficulty parseDifficulty(std::string_view text)
+    {
+        if (equalsIgnoreCase(text, "medium")) return MEDIUM;
+        if (equalsIgnoreCase(text, "hard")) return HARD;
+        return EASY;
+    }
+
+    wire::inboundMessage::gameMode parseMode(std::string_view text)
+    {
+        if (text == "single") return wire::inboundMessage::gameMode::Single;
+        if (text == "local") return wire::inboundMessage::gameMode::Local;
+        if (text == "endless") return wire::inboundMessage::gameMode::Endless;
+        return wire::inboundMessage::gameMode::Unrecognized;
+    }
+
+    wireFormat parseProtocol(std::string_view text)
+    {
+        if (text == "delta") return wireFormat::JsonDelta;
+        if (text == "binary") return wireFormat::Binary;
+        if (text == "chunked") return wireFormat::JsonChunked;
+        if (text == "binaryChunked") return wireFormat::BinaryChunked;
+        return wireFormat::JsonFull;
+    }
+}
+
+namespace wire
+{
+    bool decodeText(std::string_view text, inboundMessage& out)
+    {
+        out = inboundMessage{};
+        cursor c{ text.data(), text.data() + text.size() };
+
+        std::string_view type;
+        bool hasAction = false;
+
+        if (!expect(c, '{')) return false;
+        skipWhitespace(c);
+        if (!c.done() && c.peek() == '}') return true;
+
+        while (true) {
+            std::string_view key;
+            if (!parseString(c, key) || !expect(c, ':')) return false;
+
+            skipWhitespace(c);
+            bool isString = (!c.done() && c.peek() == '"');
+            std::string_view value;
+
+            if (key == "seed") {
+                // Numbers above 2^53 lose precision in JS, so strings are accepted too
+                const char* begin = c.p;
+                if (isString ? !parseString(c, value) : !skipValue(c)) return false;
+                if (!isString) value = std::string_view(begin, static_cast<size_t>(c.p - begin));
+                out.hasSeed = parseUnsigned(value, out.seed);
+            }
+            else if (key == "fog" && !isString) {
+                const char* begin = c.p;
+                if (!skipValue(c)) return false;
+                out.fog = std::string_view(begin, static_cast<size_t>(c.p - begin)) == "true";
+            }
+            else if (key == "playerId" && !isString) {
+                if (!parseInt(c, out.playerId)) {
+                    out.playerId = -1;
+                    if (!skipValue(c)) return false;
+                }
+            }
+            else if (isString && (key == "type" || key == "mode" || key == "difficulty" || key == "protocol" || key == "action")) {
+                if (!parseString(c, value)) return false;
+                switch (key[0]) {
+                case 't': type = value; break;
+                case 'm': out.rawMode = value; out.mode = parseMode(value); break;
+                case 'd': out.difficulty = parseDifficulty(value); break;
+                case 'p': out.protocol = parseProtocol(value); break;
+                case 'a': hasAction = true; out.hasDirection = parseAction(value, out.direction); break;
+                }
+            }
+            else if (!skipValue(c)) {
+                return false;
+            }
+
+            skipWhitespace(c);
+            if (c.done()) return false;
+            if (c.peek() == ',') { ++c.p; continue; }
+            if (c.peek() == '}') break;
+            return false;
+        }
+
+        if (type == "config") out.type = inboundMessage::kind::Config;
+        else if (type == "resync") out.type = inboundMessage::kind::Resync;
+        else if (hasAction) out.type = inboundMessage::kind::Move;
+        return true;
+    }
+
+    bool decodeBinary(std::string_view payload, inboundMessage& out)
+    {
+        out = inboundMessage{};
+
+        messageType type;
+        if (!peekType(payload, type)) return false;
+
+        if (type == messageType::Resync) {
+            out.type = inboundMessage::kind::Resync;
+            return true;
+        }
+
+        moveInput move;
+        if (!decodeMove(payload, move)) return false;
+        out.type = inboundMessage::kind::Move;
+        out.playerId = move.playerId;
+        out.hasDirection = true;
+        out.direction = move.direction;
+        return true;
+    }
+}
@@ -0,0 +1,159 @@
+#include "../Declarations/metrics.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+namespace metrics
+{
+    namespace
+    {
+        const char* STAGE_NAMES[] = { "receive", "decode", "apply", "serialize", "send", "ai_step", "generate" };
+        static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<size_t>(stage::Count), "one name per stage");
+
+        struct counterInfo
+        {
+            const char* name;
+            const char* help;
+        };
+        const counterInfo COUNTERS[] = {
+            { "labyrinth_messages_received_total", "WebSocket messages received" },
+            { "labyrinth_bytes_sent_total", "Payload bytes handed to websocketpp" },
+            { "labyrinth_send_failures_total", "Sends that websocketpp rejected" },
+            { "labyrinth_malformed_messages_total", "Messages that failed to decode" },
+        };
+        static_assert(sizeof(COUNTERS) / sizeof(COUNTERS[0]) == static_cast<size_t>(counter::Count), "one entry per counter");
+
+        const double QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+
+        histogram stages[static_cast<size_t>(stage::Count)];
+        std::atomic<uint64_t> counters[static_cast<size_t>(counter::Count)];
+
+        void appendf(std::string& out, const char* format, ...)
+        {
+            char line[256];
+            va_list args;
+            va_start(args, format);
+            int n = std::vsnprintf(line, sizeof(line), format, args);
+            va_end(args);
+            if (n > 0) out.append(line, std::min(static_cast<size_t>(n), sizeof(line) - 1));
+        }
+
+        double seconds(uint64_t nanos)
+        {
+            return static_cast<double>(nanos) / 1e9;
+        }
+    }
+
+    int histogram::bucketFor(uint64_t value)
+    {
+        const uint64_t limit = (uint64_t(1) << MAX_BITS) - 1;
+        if (value > limit) value = limit;
+        if (value < 2 * SUB_BUCKETS) return static_cast<int>(value);
+
+        int msb = 63;
+        while (!(value >> msb)) --msb;
+        int shift = msb - SUB_BITS;
+        return shift * SUB_BUCKETS + static_cast<int>(value >> shift);
+    }
+
+    uint64_t histogram::upperBound(int bucket)
+    {
+        if (bucket < 2 * SUB_BUCKETS) return static_cast<uint64_t>(bucket);
+
+        int shift = bucket / SUB_BUCKETS - 1;
+        uint64_t mantissa = static_cast<uint64_t>(bucket - shift * SUB_BUCKETS);
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    void histogram::record(uint64_t nanos)
+    {
+        buckets[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(nanos, std::memory_order_relaxed);
+
+        uint64_t seen = max.load(std::memory_order_relaxed);
+        while (nanos > seen && !max.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {}
+    }
+
+    // Not an atomic cut across buckets; a scrape racing a record may be off by one
+    histogram::summary histogram::snapshot() const
+    {
+        summary s;
+        for (int i = 0; i < BUCKETS; ++i) {
+            s.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+            s.count += s.buckets[i];
+        }
+        s.sum = sum.load(std::memory_order_relaxed);
+        s.max = max.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    uint64_t histogram::summary::quantile(double q) const
+    {
+        if (count == 0) return 0;
+
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::min(upperBound(i), max);
+        }
+        return max;
+    }
+
+    void record(stage s, std::chrono::steady_clock::duration elapsed)
+    {
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        stages[static_cast<size_t>(s)].record(nanos > 0 ? static_cast<uint64_t>(nanos) : 0);
+    }
+
+    void add(counter c, uint64_t amount)
+    {
+        counters[static_cast<size_t>(c)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    histogram::summary snapshot(stage s)
+    {
+        return stages[static_cast<size_t>(s)].snapshot();
+    }
+
+    uint64_t value(counter c)
+    {
+        return counters[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+    }
+
+    std::string render(std::initializer_list<sample> extra)
+    {
+        std::string out;
+        out.reserve(4096);
+
+        out += "# HELP labyrinth_stage_seconds Time spent in each server stage\n";
+        out += "# TYPE labyrinth_stage_seconds summary\n";
+        histogram::summary summaries[static_cast<size_t>(stage::Count)];
+        for (size_t i = 0; i < static_cast<size_t>(stage::Count); ++i) {
+            const histogram::summary& s = summaries[i] = stages[i].snapshot();
+            for (double q : QUANTILES) {
+                appendf(out, "labyrinth_stage_seconds{stage=\"%s\",quantile=\"%g\"} %.9f\n",
+                    STAGE_NAMES[i], q, seconds(s.quantile(q)));
+            }
+            appendf(out, "labyrinth_stage_seconds_sum{stage=\"%s\"} %.9f\n", STAGE_NAMES[i], seconds(s.sum));
+            appendf(out, "labyrinth_stage_seconds_count{stage=\"%s\"} %llu\n", STAGE_NAMES[i],
+                static_cast<unsigned long long>(s.count));
+        }
+
+        out += "# HELP labyrinth_stage_max_seconds Slowest recorded run of each stage\n";
+        out += "# TYPE labyrinth_stage_max_seconds gauge\n";
+        for (size_t i = 0; i < static_cast<size_t>(stage::Count); ++i) {
+            appendf(out, "labyrinth_stage_max_seconds{stage=\"%s\"} %.9f\n", STAGE_NAMES[i], seconds(summaries[i].max));
+        }
+
+        for (size_t i = 0; i < static_cast<size_t>(counter::Count); ++i) {
+            appendf(out, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", COUNTERS[i].name, COUNTERS[i].help,
+                COUNTERS[i].name, COUNTERS[i].name, static_cast<unsigned long long>(counters[i].load(std::memory_order_relaxed)));
+        }
+
+        for (const sample& s : extra) {
+            appendf(out, "# HELP %s %s\n# TYPE %s %s\n%s %.17g\n", s.name, s.help, s.name, s.type, s.name, s.value);
+        }
+        return out;
+    }
+}
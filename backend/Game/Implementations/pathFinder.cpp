@@ -0,0 +1,495 @@
+#include "../Declarations/pathFinder.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+void pathFinder::prepare(const labyrinthMap& map)
+{
+    width = map.getWidth();
+    height = map.getHeight();
+
+    size_t cells = static_cast<size_t>(width) * height;
+    if (seen.size() < cells) {
+        // Only grows; stale stamps in reused memory are older generations
+        seen.resize(cells, 0);
+        closed.resize(cells, 0);
+        g.resize(cells, 0);
+        parent.resize(cells, -1);
+    }
+}
+
+uint32_t pathFinder::nextGeneration()
+{
+    if (++generation == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(closed.begin(), closed.end(), 0);
+        std::fill(nodeSeen.begin(), nodeSeen.end(), 0);
+        std::fill(nodeClosed.begin(), nodeClosed.end(), 0);
+        generation = 1;
+    }
+    return generation;
+}
+
+bool pathFinder::isOpen(const labyrinthMap& map, int cell) const
+{
+    return cell >= 0 && cell < width * height && !map.isWall(cell);
+}
+
+void pathFinder::tracePath(int to, std::vector<int>& path) const
+{
+    path.clear();
+    for (int cell = to; cell != -1; cell = parent[cell]) {
+        path.push_back(cell);
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+bool pathFinder::findPath(const labyrinthMap& map, int from, int to, std::vector<int>& path)
+{
+    path.clear();
+    expanded = 0;
+    prepare(map);
+    if (!isOpen(map, from) || !isOpen(map, to)) return false;
+
+    uint32_t gen = nextGeneration();
+    int goalX = to % width;
+    int goalY = to / width;
+    auto heuristic = [&](int cell) {
+        return static_cast<uint32_t>(std::abs(cell % width - goalX) + std::abs(cell / width - goalY));
+    };
+
+    for (auto& bucket : buckets) bucket.clear();
+
+    seen[from] = gen;
+    g[from] = 0;
+    parent[from] = -1;
+    uint32_t f = heuristic(from);
+    buckets[f % RING].push_back(from);
+    size_t open = 1;
+
+    while (open > 0) {
+        auto& bucket = buckets[f % RING];
+        if (bucket.empty()) {
+            ++f;
+            continue;
+        }
+
+        int cell = bucket.back();
+        bucket.pop_back();
+        --open;
+
+        // Superseded by a cheaper push, or already expanded
+        if (closed[cell] == gen || g[cell] + heuristic(cell) != f) continue;
+        closed[cell] = gen;
+        ++expanded;
+
+        if (cell == to) {
+            tracePath(to, path);
+            return true;
+        }
+
+        int x = cell % width;
+        int y = cell / width;
+        const int neighbours[4] = {
+            y > 0 ? cell - width : -1,
+            y < height - 1 ? cell + width : -1,
+            x > 0 ? cell - 1 : -1,
+            x < width - 1 ? cell + 1 : -1
+        };
+
+        uint32_t nextG = g[cell] + 1;
+        for (int n : neighbours) {
+            if (n < 0 || map.isWall(n)) continue;
+            if (seen[n] == gen && g[n] <= nextG) continue;
+
+            seen[n] = gen;
+            g[n] = nextG;
+            parent[n] = cell;
+            buckets[(nextG + heuristic(n)) % RING].push_back(n);
+            ++open;
+        }
+    }
+
+    return false;
+}
+
+int pathFinder::distance(const labyrinthMap& map, int from, int to)
+{
+    // frontier is idle outside findPaths, so it doubles as the path scratch
+    if (!findPath(map, from, to, frontier)) return -1;
+    return static_cast<int>(g[to]);
+}
+
+size_t pathFinder::findPaths(const labyrinthMap& map, const std::vector<int>& sources, int to,
+    std::vector<std::vector<int>>& paths)
+{
+    paths.resize(sources.size());
+    for (auto& path : paths) path.clear();
+
+    expanded = 0;
+    prepare(map);
+    if (!isOpen(map, to)) return 0;
+
+    // Reverse BFS from the shared target; g is the distance to it
+    uint32_t gen = nextGeneration();
+    frontier.clear();
+    seen[to] = gen;
+    g[to] = 0;
+    parent[to] = -1;
+    frontier.push_back(to);
+
+    for (size_t head = 0; head < frontier.size(); ++head) {
+        int cell = frontier[head];
+        int x = cell % width;
+        int y = cell / width;
+        const int neighbours[4] = {
+            y > 0 ? cell - width : -1,
+            y < height - 1 ? cell + width : -1,
+            x > 0 ? cell - 1 : -1,
+            x < width - 1 ? cell + 1 : -1
+        };
+        for (int n : neighbours) {
+            if (n < 0 || map.isWall(n) || seen[n] == gen) continue;
+            seen[n] = gen;
+            g[n] = g[cell] + 1;
+            parent[n] = cell;   // Points toward the target
+            frontier.push_back(n);
+        }
+    }
+    expanded = frontier.size();
+
+    size_t reachable = 0;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        int source = sources[i];
+        if (!isOpen(map, source) || seen[source] != gen) continue;
+
+        auto& path = paths[i];
+        for (int cell = source; cell != -1; cell = parent[cell]) {
+            path.push_back(cell);
+        }
+        ++reachable;
+    }
+    return reachable;
+}
+
+void pathFinder::prepareNodes(size_t count)
+{
+    if (nodeSeen.size() < count) {
+        nodeSeen.resize(count, 0);
+        nodeClosed.resize(count, 0);
+        nodeG.resize(count, 0);
+        nodeParent.resize(count, -1);
+        nodeVia.resize(count, -1);
+    }
+}
+
+// Appends the cells of `edge` stepping from offset `from` to offset `to`,
+// leaving out the cell at `from`
+void pathFinder::walkEdge(const junctionGraph& graph, int edge, uint32_t from, uint32_t to, std::vector<int>& path)
+{
+    while (from != to) {
+        from = from < to ? from + 1 : from - 1;
+        path.push_back(graph.cellOnEdge(edge, from));
+    }
+}
+
+bool pathFinder::findPath(const labyrinthMap& map, const junctionGraph& graph, int from, int to, std::vector<int>& path)
+{
+    path.clear();
+    expanded = 0;
+    prepare(map);
+    prepareNodes(graph.nodeCount());
+    if (!isOpen(map, from) || !isOpen(map, to)) return false;
+    if (from == to) {
+        path.push_back(from);
+        return true;
+    }
+
+    uint32_t gen = nextGeneration();
+    int goalX = to % width;
+    int goalY = to / width;
+    auto heuristic = [&](int node) {
+        int cell = graph.getNode(node).cell;
+        return static_cast<uint32_t>(std::abs(cell % width - goalX) + std::abs(cell / width - goalY));
+    };
+
+    // Either end is a node, or a place on a corridor reached through the
+    // nodes at its ends
+    int sourceNode = graph.nodeAt(from);
+    int sourceEdge = graph.edgeAt(from);
+    uint32_t sourceOffset = sourceEdge >= 0 ? graph.offsetOnEdge(from) : 0;
+    int targetNode = graph.nodeAt(to);
+    int targetEdge = graph.edgeAt(to);
+    uint32_t targetOffset = targetEdge >= 0 ? graph.offsetOnEdge(to) : 0;
+
+    auto touchesTarget = [&](int node) {
+        if (targetEdge < 0) return false;
+        const auto& e = graph.getEdge(targetEdge);
+        return e.from == node || e.to == node;
+    };
+
+    heap.clear();
+    auto push = [&](int node, uint32_t cost, int parentNode, int via) {
+        if (nodeSeen[node] == gen && nodeG[node] <= cost) return;
+        nodeSeen[node] = gen;
+        nodeG[node] = cost;
+        nodeParent[node] = parentNode;
+        nodeVia[node] = via;
+        heap.emplace_back(cost + heuristic(node), node);
+        std::push_heap(heap.begin(), heap.end(), std::greater<>());
+    };
+
+    if (sourceNode >= 0) {
+        push(sourceNode, 0, -1, -1);
+    } else {
+        const auto& e = graph.getEdge(sourceEdge);
+        push(e.from, sourceOffset, -1, sourceEdge);
+        push(e.to, e.length - sourceOffset, -1, sourceEdge);
+    }
+
+    // Best complete route so far: its length and the node it leaves the graph at
+    uint32_t best = UINT32_MAX;
+    int bestNode = -1;
+    if (sourceEdge >= 0 && sourceEdge == targetEdge) {
+        best = sourceOffset > targetOffset ? sourceOffset - targetOffset : targetOffset - sourceOffset;
+    }
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        auto [f, node] = heap.back();
+        heap.pop_back();
+
+        if (f >= best) break;
+        if (nodeClosed[node] == gen || nodeG[node] + heuristic(node) != f) continue;
+        nodeClosed[node] = gen;
+        ++expanded;
+
+        uint32_t cost = nodeG[node];
+        if (node == targetNode) {
+            best = cost;
+            bestNode = node;
+            break;
+        }
+        if (targetEdge >= 0) {
+            const auto& e = graph.getEdge(targetEdge);
+            uint32_t total = UINT32_MAX;
+            if (e.from == node) total = cost + targetOffset;
+            if (e.to == node) total = std::min(total, cost + e.length - targetOffset);
+            if (total < best) {
+                best = total;
+                bestNode = node;
+            }
+        }
+
+        const uint32_t* edges = graph.edgesOf(node);
+        for (uint32_t i = 0; i < graph.getNode(node).degree; ++i) {
+            const auto& e = graph.getEdge(edges[i]);
+            int next = junctionGraph::otherEnd(e, node);
+            if (nodeClosed[next] == gen) continue;
+            // Dead ends lead nowhere unless the target is there
+            if (graph.getNode(next).degree == 1 && next != targetNode && !touchesTarget(next)) continue;
+            push(next, cost + e.length, node, static_cast<int>(edges[i]));
+        }
+    }
+
+    if (best == UINT32_MAX) return false;
+
+    // Built backwards from the target, then reversed
+    path.push_back(to);
+    if (bestNode < 0) {
+        // Along the corridor both ends share, without touching a node
+        walkEdge(graph, targetEdge, targetOffset, sourceOffset, path);
+    } else {
+        int node = bestNode;
+        if (targetEdge >= 0) {
+            const auto& e = graph.getEdge(targetEdge);
+            bool fromEnd = e.from == node && nodeG[node] + targetOffset == best;
+            walkEdge(graph, targetEdge, targetOffset, fromEnd ? 0 : e.length, path);
+        }
+        while (nodeParent[node] != -1) {
+            const auto& e = graph.getEdge(nodeVia[node]);
+            walkEdge(graph, nodeVia[node], e.from == node ? 0 : e.length, e.from == node ? e.length : 0, path);
+            node = nodeParent[node];
+        }
+        if (sourceEdge >= 0) {
+            const auto& e = graph.getEdge(sourceEdge);
+            bool fromEnd = e.from == node && nodeG[node] == sourceOffset;
+            walkEdge(graph, sourceEdge, fromEnd ? 0 : e.length, sourceOffset, path);
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+int pathFinder::distance(const labyrinthMap& map, const junctionGraph& graph, int from, int to)
+{
+    if (!findPath(map, graph, from, to, frontier)) return -1;
+    return static_cast<int>(frontier.size()) - 1;
+}
+
+// BFS from `from` over the open cells of its cluster; g and parent are
+// valid where seen equals the returned generation
+uint32_t pathFinder::searchCluster(const labyrinthMap& map, const hierarchicalGraph& graph, int from)
+{
+    int x0, y0, x1, y1;
+    graph.clusterBounds(graph.clusterOf(from), x0, y0, x1, y1);
+
+    uint32_t gen = nextGeneration();
+    frontier.clear();
+    seen[from] = gen;
+    g[from] = 0;
+    parent[from] = -1;
+    frontier.push_back(from);
+
+    for (size_t head = 0; head < frontier.size(); ++head) {
+        int cell = frontier[head];
+        int x = cell % width;
+        int y = cell / width;
+        const int neighbours[4] = {
+            y > y0 ? cell - width : -1,
+            y < y1 - 1 ? cell + width : -1,
+            x > x0 ? cell - 1 : -1,
+            x < x1 - 1 ? cell + 1 : -1
+        };
+        for (int n : neighbours) {
+            if (n < 0 || map.isWall(n) || seen[n] == gen) continue;
+            seen[n] = gen;
+            g[n] = g[cell] + 1;
+            parent[n] = cell;
+            frontier.push_back(n);
+        }
+    }
+    expanded += frontier.size();
+    return gen;
+}
+
+// Appends the cells after `from` on a shortest way to `to` inside their cluster
+bool pathFinder::appendClusterPath(const labyrinthMap& map, const hierarchicalGraph& graph, int from, int to, std::vector<int>& path)
+{
+    uint32_t gen = searchCluster(map, graph, from);
+    if (seen[to] != gen) return false;
+
+    size_t mark = path.size();
+    for (int cell = to; cell != from; cell = parent[cell]) {
+        path.push_back(cell);
+    }
+    std::reverse(path.begin() + mark, path.end());
+    return true;
+}
+
+bool pathFinder::findPath(const labyrinthMap& map, const hierarchicalGraph& graph, int from, int to, std::vector<int>& path)
+{
+    path.clear();
+    expanded = 0;
+    prepare(map);
+    prepareNodes(graph.nodeCount());
+    if (!isOpen(map, from) || !isOpen(map, to)) return false;
+    if (from == to) {
+        path.push_back(from);
+        return true;
+    }
+
+    // Ways out of the target's cluster to the target, then ways into the
+    // graph from the source's cluster
+    int targetCluster = graph.clusterOf(to);
+    uint32_t targetGen = searchCluster(map, graph, to);
+    exits.clear();
+    for (int id : graph.clusterNodes(targetCluster)) {
+        int cell = graph.getNode(id).cell;
+        if (seen[cell] == targetGen) exits.emplace_back(id, g[cell]);
+    }
+
+    uint32_t sourceGen = searchCluster(map, graph, from);
+    uint32_t best = UINT32_MAX;
+    int bestNode = -1;
+    if (seen[to] == sourceGen) best = g[to];
+
+    uint32_t gen = nextGeneration();
+    int goalX = to % width;
+    int goalY = to / width;
+    auto heuristic = [&](int node) {
+        int cell = graph.getNode(node).cell;
+        return static_cast<uint32_t>(std::abs(cell % width - goalX) + std::abs(cell / width - goalY));
+    };
+
+    heap.clear();
+    auto push = [&](int node, uint32_t cost, int parentNode) {
+        if (nodeSeen[node] == gen && nodeG[node] <= cost) return;
+        nodeSeen[node] = gen;
+        nodeG[node] = cost;
+        nodeParent[node] = parentNode;
+        heap.emplace_back(cost + heuristic(node), node);
+        std::push_heap(heap.begin(), heap.end(), std::greater<>());
+    };
+
+    for (int id : graph.clusterNodes(graph.clusterOf(from))) {
+        int cell = graph.getNode(id).cell;
+        if (seen[cell] == sourceGen) push(id, g[cell], -1);
+    }
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        auto [f, node] = heap.back();
+        heap.pop_back();
+
+        if (f >= best) break;
+        if (nodeClosed[node] == gen || nodeG[node] + heuristic(node) != f) continue;
+        nodeClosed[node] = gen;
+        ++expanded;
+
+        const auto& n = graph.getNode(node);
+        uint32_t cost = nodeG[node];
+        if (n.cluster == targetCluster) {
+            for (const auto& [id, exitCost] : exits) {
+                if (id == node && cost + exitCost < best) {
+                    best = cost + exitCost;
+                    bestNode = node;
+                }
+            }
+        }
+
+        for (const auto& l : n.intra) {
+            if (nodeClosed[l.to] != gen) push(l.to, cost + l.cost, node);
+        }
+        for (const auto& l : n.inter) {
+            if (nodeClosed[l.to] != gen) push(l.to, cost + l.cost, node);
+        }
+    }
+
+    if (best == UINT32_MAX) return false;
+
+    // Node to node: across a border is one step, within a cluster a short
+    // search there
+    path.push_back(from);
+    int at = from;
+    if (bestNode >= 0) {
+        chain.clear();
+        for (int node = bestNode; node != -1; node = nodeParent[node]) {
+            chain.push_back(node);
+        }
+        std::reverse(chain.begin(), chain.end());
+
+        for (int node : chain) {
+            int cell = graph.getNode(node).cell;
+            if (cell == at) continue;
+            if (graph.clusterOf(cell) != graph.clusterOf(at)) path.push_back(cell);
+            else if (!appendClusterPath(map, graph, at, cell, path)) break;
+            at = cell;
+        }
+    }
+    if (at != to && !appendClusterPath(map, graph, at, to, path)) {
+        // Only when the graph is stale for this map
+        path.clear();
+        return false;
+    }
+    return true;
+}
+
+Player::PlayerDirection pathFinder::directionBetween(const labyrinthMap& map, int from, int to)
+{
+    int delta = to - from;
+    if (delta == -map.getWidth()) return Player::PlayerDirection::MoveUp;
+    if (delta == map.getWidth()) return Player::PlayerDirection::MoveDown;
+    if (delta == -1) return Player::PlayerDirection::MoveLeft;
+    return Player::PlayerDirection::MoveRight;
+}
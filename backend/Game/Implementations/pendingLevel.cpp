@@ -0,0 +1,58 @@
+#include "../Declarations/pendingLevel.hpp"
+#include "../Declarations/logger.hpp"
+
+pendingLevel::pendingLevel(int width, int height, uint64_t seed)
+    : map(width, height), seed(seed)
+{
+}
+
+pendingLevel::pendingLevel(labyrinthMap finished)
+    : status(state::Ready), map(std::move(finished))
+{
+}
+
+std::shared_ptr<pendingLevel> pendingLevel::generateAsync(asio::io_context::executor_type pool, int width, int height, uint64_t seed)
+{
+    auto level = std::make_shared<pendingLevel>(width, height, seed);
+    std::weak_ptr<pendingLevel> weak = level;
+
+    asio::post(pool, [weak]() {
+        if (auto level = weak.lock()) {
+            if (level->claim()) level->build();
+        }
+        });
+
+    return level;
+}
+
+bool pendingLevel::claim()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (status != state::Queued) return false;
+    status = state::Building;
+    return true;
+}
+
+// Runs outside the lock; only the claimant touches `map` while Building
+void pendingLevel::build()
+{
+    map.generateLabyrinth(seed);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        status = state::Ready;
+    }
+    ready.notify_all();
+}
+
+labyrinthMap pendingLevel::take()
+{
+    if (claim()) {
+        LOG_DEBUG("Level not started by the pool yet; generating inline");
+        build();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [this] { return status == state::Ready; });
+    status = state::Taken;
+    return std::move(map);
+}
@@ -1,8 +1,9 @@
-#include <iostream>
 #include <algorithm>
+#include <cctype>
 #include <cstdlib>
-#include "../Declarations/inputHandler.hpp"
+#include <stdexcept>
 #include "../Declarations/player.hpp"
+#include "../Declarations/logger.hpp"
 
 Player::Player(int Id, char character, int x, int y)
     : Id(Id), character(character), x(x), y(y) {
@@ -12,8 +13,7 @@ Player::Player(Player&& other) noexcept
     : Id(std::exchange(other.Id, 0)),
     character(std::exchange(other.character, '\0')),
     x(std::exchange(other.x, 0)),
-    y(std::exchange(other.y, 0)),
-    inputHandlerPtr(std::move(other.inputHandlerPtr)) {
+    y(std::exchange(other.y, 0)) {
 }
 
 Player& Player::operator=(Player&& other) noexcept
@@ -24,26 +24,39 @@ Player& Player::operator=(Player&& other) noexcept
         character = std::exchange(other.character, '\0');
         x = std::exchange(other.x, 0);
         y = std::exchange(other.y, 0);
-        inputHandlerPtr = std::move(other.inputHandlerPtr);
     }
     return *this;
 }
 
 Player::PlayerDirection Player::stringToDirection(const std::string& actionInput)
 {
-    std::string action = actionInput;
-    std::transform(action.begin(), action.end(), action.begin(), ::tolower);
+    PlayerDirection direction;
+    if (!tryParseDirection(actionInput, direction))
+        throw std::invalid_argument("Invalid action");
+    return direction;
+}
 
-    if (action == "up" || action == "w" || action == "u")
-        return Player::PlayerDirection::MoveUp;
-    else if (action == "down" || action == "s" || action == "d")
-        return Player::PlayerDirection::MoveDown;
-    else if (action == "left" || action == "a" || action == "l")
-        return Player::PlayerDirection::MoveLeft;
-    else if (action == "right" || action == "r")
-        return Player::PlayerDirection::MoveRight;
+bool Player::tryParseDirection(std::string_view action, PlayerDirection& out)
+{
+    auto is = [&action](std::string_view word) {
+        if (action.size() != word.size()) return false;
+        for (size_t i = 0; i < word.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(action[i])) != word[i]) return false;
+        }
+        return true;
+    };
+
+    if (is("up") || is("w") || is("u"))
+        out = PlayerDirection::MoveUp;
+    else if (is("down") || is("s") || is("d"))
+        out = PlayerDirection::MoveDown;
+    else if (is("left") || is("a") || is("l"))
+        out = PlayerDirection::MoveLeft;
+    else if (is("right") || is("r"))
+        out = PlayerDirection::MoveRight;
     else
-        throw std::invalid_argument("Invalid action");
+        return false;
+    return true;
 }
 
 void Player::setMapSize(int size)
@@ -65,7 +78,7 @@ void Player::move(Player::PlayerDirection direction)
     else if (direction == PlayerDirection::MoveRight)
         newX += 1;
     else {
-        std::cerr << "Unknown direction" << std::endl;
+        LOG_WARN("Unknown direction", { {"direction", direction} });
         return;
     }
 
@@ -120,15 +133,6 @@ std::pair<int, int> Player::actionToDelta(const std::string& action)
     return std::make_pair(deltaX, deltaY);
 }
 
-void Player::update(std::string message)
-{
-    auto [player, action] = this->inputHandlerPtr->handleWebSocketInput(message);
-    auto [deltaX, deltaY] = this->actionToDelta(action);
-    x += deltaX;
-    y += deltaY;
-    std::cout << "Player " << Id << " is at " << x << ", " << y << std::endl;
-}
-
 std::pair<int, int> Player::getPosition() const {
     return { x, y };
 }
@@ -0,0 +1,556 @@
+#include "../Declarations/roomBroadcaster.hpp"
+#include "../Declarations/logger.hpp"
+#include "../Declarations/metrics.hpp"
+
+namespace
+{
+    // Chunked peers get every tile within this many cells of their player,
+    // plus a margin so the next few moves don't wait on a tile
+    const int VIEWPORT_RADIUS = 24;
+    const int VIEWPORT_MARGIN = 8;
+
+    wire::positions toPositions(const gameFrame& frame)
+    {
+        wire::positions pos;
+        pos.playerX = static_cast<uint16_t>(frame.playerX);
+        pos.playerY = static_cast<uint16_t>(frame.playerY);
+        pos.hasAI = frame.hasAI;
+        pos.aiX = static_cast<uint16_t>(frame.aiX);
+        pos.aiY = static_cast<uint16_t>(frame.aiY);
+        return pos;
+    }
+}
+
+roomBroadcaster::roomBroadcaster(server& websocketServer, roomExecutor outbox)
+    : websocketServer(websocketServer), outbox(outbox)
+{
+}
+
+void roomBroadcaster::publishLevel(std::shared_ptr<const labyrinthMap> map, int version, bool fog)
+{
+    asio::post(outbox, [self = shared_from_this(), map = std::move(map), version, fog]() {
+        self->level = map;
+        self->levelVersion = version;
+        // Nothing may send a fog level whole, so skip building its rows
+        self->levelRows = fog ? nlohmann::json() : nlohmann::json(map->getLabyrinth());
+        self->fogLevel = fog;
+        self->revealed.clear();
+        self->endlessLevel = false;
+        self->rowBatches.clear();
+        self->tiles.reset();
+        // Frames for this level may have been skipped while it was in flight
+        self->flush();
+        });
+}
+
+void roomBroadcaster::publishRows(std::shared_ptr<const endlessRows> rows, int version)
+{
+    asio::post(outbox, [self = shared_from_this(), rows = std::move(rows), version]() {
+        if (!self->endlessLevel || self->levelVersion != version) {
+            self->level.reset();
+            self->levelRows = nlohmann::json();
+            self->levelVersion = version;
+            self->endlessLevel = true;
+            self->fogLevel = false;
+            self->revealed.clear();
+            self->rowBatches.clear();
+            self->tiles.reset();
+        }
+
+        // Batches wholly above what the maze still holds are no use to anyone
+        int keepFrom = rows->keepFrom;
+        self->rowBatches.push_back({ std::move(rows), {}, {} });
+        while (self->rowBatches.size() > 1 && self->rowBatches.front().rows->endRow() <= keepFrom) {
+            self->rowBatches.pop_front();
+        }
+        self->flush();
+        });
+}
+
+void roomBroadcaster::publishReveal(std::vector<uint32_t> cells, int version)
+{
+    // Sent with the next flush, which the move that revealed them triggers
+    asio::post(outbox, [self = shared_from_this(), cells = std::move(cells), version]() {
+        if (!self->fogLevel || self->levelVersion != version) return;
+        self->revealed.insert(self->revealed.end(), cells.begin(), cells.end());
+        });
+}
+
+void roomBroadcaster::publish(const gameFrame& frame)
+{
+    frames.publish(frame);
+
+    // One queued flush serves every frame published before it runs
+    if (!flushPending.exchange(true, std::memory_order_acq_rel)) {
+        asio::post(outbox, [self = shared_from_this()]() {
+            self->flushPending.store(false, std::memory_order_release);
+            self->flush();
+            });
+    }
+}
+
+void roomBroadcaster::announceWinner(int playerId)
+{
+    asio::post(outbox, [self = shared_from_this(), playerId]() {
+        // Final positions go out before the game-over message
+        if (self->flushPending.exchange(false, std::memory_order_acq_rel)) {
+            self->flush();
+        }
+        self->sendGameOver(playerId);
+        });
+}
+
+void roomBroadcaster::addConnection(websocketpp::connection_hdl hdl)
+{
+    asio::post(outbox, [self = shared_from_this(), hdl]() {
+        self->connections.emplace(hdl, peerState{});
+        });
+}
+
+void roomBroadcaster::removeConnection(websocketpp::connection_hdl hdl)
+{
+    asio::post(outbox, [self = shared_from_this(), hdl]() {
+        self->connections.erase(hdl);
+        });
+}
+
+void roomBroadcaster::setFormat(websocketpp::connection_hdl hdl, wireFormat format)
+{
+    asio::post(outbox, [self = shared_from_this(), hdl, format]() {
+        auto peer = self->connections.find(hdl);
+        if (peer != self->connections.end()) {
+            peer->second.format = format;
+        }
+        });
+}
+
+void roomBroadcaster::resync(websocketpp::connection_hdl hdl)
+{
+    asio::post(outbox, [self = shared_from_this(), hdl]() {
+        self->sendSnapshot(hdl, self->frames.read());
+        });
+}
+
+void roomBroadcaster::flush()
+{
+    if ((!level && !endlessLevel) || frames.published() == 0) return;
+
+    gameFrame frame = frames.read();
+    if (frame.level != levelVersion) return;   // Its level is still on the way
+
+    stateSeq++;
+    if (endlessLevel) {
+        flushEndless(frame);
+        return;
+    }
+    if (fogLevel) {
+        flushFog(frame);
+        return;
+    }
+
+    // Build each payload at most once, and only if some peer needs it
+    std::string snapshot, delta, levelBlob, update;
+    const auto binary = websocketpp::frame::opcode::binary;
+
+    for (auto& [hdl, peer] : connections)
+    {
+        bool knowsLevel = (peer.knownLevel == levelVersion);
+        peer.knownLevel = levelVersion;
+
+        switch (peer.format)
+        {
+        case wireFormat::JsonFull:
+            if (snapshot.empty()) snapshot = fullState(frame);
+            sendTo(hdl, snapshot);
+            break;
+        case wireFormat::JsonDelta:
+            if (knowsLevel) {
+                if (delta.empty()) delta = deltaState(frame);
+                sendTo(hdl, delta);
+            }
+            else {
+                if (snapshot.empty()) snapshot = fullState(frame);
+                sendTo(hdl, snapshot);
+            }
+            break;
+        case wireFormat::Binary:
+            if (knowsLevel) {
+                if (update.empty()) update = binaryUpdate(frame);
+                sendTo(hdl, update, binary);
+            }
+            else {
+                if (levelBlob.empty()) levelBlob = binaryLevel(frame);
+                sendTo(hdl, levelBlob, binary);
+            }
+            break;
+        case wireFormat::JsonChunked:
+            sendChunks(hdl, peer, frame, knowsLevel);
+            if (delta.empty()) delta = deltaState(frame);
+            sendTo(hdl, delta);
+            break;
+        case wireFormat::BinaryChunked:
+            sendChunks(hdl, peer, frame, knowsLevel);
+            if (update.empty()) update = binaryUpdate(frame);
+            sendTo(hdl, update, binary);
+            break;
+        }
+    }
+}
+
+// Rows each peer is missing, then positions. JsonFull peers get the full
+// state without the maze, which they build from the rows messages.
+void roomBroadcaster::flushEndless(const gameFrame& frame)
+{
+    std::string state, delta, update;
+
+    for (auto& [hdl, peer] : connections)
+    {
+        if (peer.knownLevel != levelVersion) {
+            peer.knownLevel = levelVersion;
+            peer.knownRow = 0;
+        }
+        sendRows(hdl, peer);
+
+        switch (peer.format)
+        {
+        case wireFormat::JsonFull:
+            if (state.empty()) state = fullState(frame);
+            sendTo(hdl, state);
+            break;
+        case wireFormat::JsonDelta:
+        case wireFormat::JsonChunked:
+            if (delta.empty()) delta = deltaState(frame);
+            sendTo(hdl, delta);
+            break;
+        case wireFormat::Binary:
+        case wireFormat::BinaryChunked:
+            if (update.empty()) update = binaryUpdate(frame);
+            sendTo(hdl, update, websocketpp::frame::opcode::binary);
+            break;
+        }
+    }
+}
+
+void roomBroadcaster::sendRows(websocketpp::connection_hdl hdl, peerState& peer)
+{
+    for (rowBatch& batch : rowBatches)
+    {
+        if (batch.rows->endRow() <= peer.knownRow) continue;
+
+        if (isBinary(peer.format)) {
+            if (batch.binary.empty()) {
+                metrics::timer t(metrics::stage::Serialize);
+                batch.binary = wire::encodeRows(*batch.rows, static_cast<uint32_t>(levelVersion));
+            }
+            sendTo(hdl, batch.binary, websocketpp::frame::opcode::binary);
+        }
+        else {
+            if (batch.json.empty()) batch.json = jsonRows(*batch.rows);
+            sendTo(hdl, batch.json);
+        }
+        peer.knownRow = batch.rows->endRow();
+    }
+}
+
+// A level header if the level is new to the peer, then every tile around its
+// player that it does not hold yet. Positions are the
+// caller's to send.
+void roomBroadcaster::sendChunks(websocketpp::connection_hdl hdl, peerState& peer, const gameFrame& frame, bool knowsLevel)
+{
+    if (!tiles) tiles = std::make_unique<chunkedMap>(level, static_cast<uint32_t>(levelVersion));
+    bool binary = isBinary(peer.format);
+    const auto opcode = binary ? websocketpp::frame::opcode::binary : websocketpp::frame::opcode::text;
+
+    if (!knowsLevel || peer.chunks.size() != static_cast<size_t>(tiles->count())) {
+        peer.chunks.assign(tiles->count(), false);
+        std::string info;
+        {
+            metrics::timer t(metrics::stage::Serialize);
+            info = binary
+                ? wire::encodeLevelInfo(*level, static_cast<uint32_t>(levelVersion), static_cast<uint32_t>(stateSeq), chunkedMap::CHUNK_SIZE, toPositions(frame))
+                : jsonLevelInfo(chunkedMap::CHUNK_SIZE);
+        }
+        sendTo(hdl, info, opcode);
+    }
+
+    // {"type":"chunks","level":n,"chunks":[tile,...]} with the cached tiles
+    // spliced in; binary peers get one ChunkBlob per tile
+    std::string batch;
+    pending.clear();
+    {
+        metrics::timer t(metrics::stage::Serialize);
+        tiles->chunksAround(frame.playerX, frame.playerY, VIEWPORT_RADIUS + VIEWPORT_MARGIN, viewport);
+        for (int chunk : viewport) {
+            if (peer.chunks[chunk]) continue;
+            peer.chunks[chunk] = true;
+
+            if (binary) {
+                pending.push_back(&tiles->binary(chunk));
+                continue;
+            }
+            batch += batch.empty()
+                ? "{\"type\":\"chunks\",\"level\":" + std::to_string(levelVersion) + ",\"chunks\":["
+                : ",";
+            batch += tiles->json(chunk);
+        }
+        if (!batch.empty()) batch += "]}";
+    }
+
+    for (const std::string* blob : pending) sendTo(hdl, *blob, opcode);
+    if (!batch.empty()) sendTo(hdl, batch);
+}
+
+// Whatever the format, fog peers get a level header, the cells revealed
+// since their last flush, and positions
+void roomBroadcaster::flushFog(const gameFrame& frame)
+{
+    std::string delta, update;
+
+    for (auto& [hdl, peer] : connections)
+    {
+        bool knowsLevel = (peer.knownLevel == levelVersion);
+        peer.knownLevel = levelVersion;
+        sendReveals(hdl, peer, frame, knowsLevel);
+
+        if (isBinary(peer.format)) {
+            if (update.empty()) update = binaryUpdate(frame);
+            sendTo(hdl, update, websocketpp::frame::opcode::binary);
+        }
+        else {
+            if (delta.empty()) delta = deltaState(frame);
+            sendTo(hdl, delta);
+        }
+    }
+}
+
+void roomBroadcaster::sendReveals(websocketpp::connection_hdl hdl, peerState& peer, const gameFrame& frame, bool knowsLevel)
+{
+    bool binary = isBinary(peer.format);
+    const auto opcode = binary ? websocketpp::frame::opcode::binary : websocketpp::frame::opcode::text;
+
+    std::string header, cells;
+    {
+        metrics::timer t(metrics::stage::Serialize);
+        if (!knowsLevel) {
+            peer.knownRevealed = 0;
+            header = binary
+                ? wire::encodeLevelInfo(*level, static_cast<uint32_t>(levelVersion), static_cast<uint32_t>(stateSeq), 0, toPositions(frame))
+                : jsonLevelInfo(0);
+        }
+        if (peer.knownRevealed < revealed.size()) {
+            cells = binary
+                ? wire::encodeReveal(static_cast<uint32_t>(levelVersion), *level, revealed.data() + peer.knownRevealed, revealed.size() - peer.knownRevealed)
+                : jsonReveal(peer.knownRevealed);
+            peer.knownRevealed = revealed.size();
+        }
+    }
+
+    if (!header.empty()) sendTo(hdl, header, opcode);
+    if (!cells.empty()) sendTo(hdl, cells, opcode);
+}
+
+void roomBroadcaster::sendGameOver(int winner)
+{
+    nlohmann::json message;
+    message["type"] = "gameOver";
+    message["winner"] = winner;
+
+    std::string payload = message.dump();
+    std::string binaryPayload = wire::encodeGameOver(winner);
+
+    for (const auto& [hdl, peer] : connections)
+    {
+        if (isBinary(peer.format)) {
+            sendTo(hdl, binaryPayload, websocketpp::frame::opcode::binary);
+        }
+        else {
+            sendTo(hdl, payload);
+        }
+    }
+}
+
+// Full state for a single peer that lost track of the delta stream
+void roomBroadcaster::sendSnapshot(websocketpp::connection_hdl hdl, const gameFrame& frame)
+{
+    auto peer = connections.find(hdl);
+    if (peer == connections.end()) return;
+
+    if ((!level && !endlessLevel) || frame.level != levelVersion)
+    {
+        LOG_WARN("⚠️ Resync requested before a level exists. Ignoring.");
+        return;
+    }
+
+    if (fogLevel) {
+        peer->second.knownLevel = levelVersion;
+        sendReveals(hdl, peer->second, frame, false);
+        if (isBinary(peer->second.format)) {
+            sendTo(hdl, binaryUpdate(frame), websocketpp::frame::opcode::binary);
+        }
+        else {
+            sendTo(hdl, deltaState(frame));
+        }
+        return;
+    }
+
+    if (endlessLevel) {
+        peer->second.knownLevel = levelVersion;
+        peer->second.knownRow = 0;
+        sendRows(hdl, peer->second);
+        if (isBinary(peer->second.format)) {
+            sendTo(hdl, binaryUpdate(frame), websocketpp::frame::opcode::binary);
+        }
+        else {
+            sendTo(hdl, fullState(frame));
+        }
+        return;
+    }
+
+    switch (peer->second.format) {
+    case wireFormat::JsonFull:
+    case wireFormat::JsonDelta:
+        sendTo(hdl, fullState(frame));
+        break;
+    case wireFormat::Binary:
+        sendTo(hdl, binaryLevel(frame), websocketpp::frame::opcode::binary);
+        break;
+    case wireFormat::JsonChunked:
+        sendChunks(hdl, peer->second, frame, false);
+        sendTo(hdl, deltaState(frame));
+        break;
+    case wireFormat::BinaryChunked:
+        sendChunks(hdl, peer->second, frame, false);
+        sendTo(hdl, binaryUpdate(frame), websocketpp::frame::opcode::binary);
+        break;
+    }
+    peer->second.knownLevel = levelVersion;
+}
+
+void roomBroadcaster::sendTo(websocketpp::connection_hdl hdl, const std::string& payload, websocketpp::frame::opcode::value opcode)
+{
+    websocketpp::lib::error_code ec;
+    {
+        metrics::timer t(metrics::stage::Send);
+        websocketServer.send(hdl, payload, opcode, ec);
+    }
+    if (ec)
+    {
+        metrics::add(metrics::counter::FailedSends);
+        LOG_ERROR("❌ Send failed", { {"error", ec.message()} });
+        return;
+    }
+    metrics::add(metrics::counter::BytesOut, payload.size());
+}
+
+std::string roomBroadcaster::fullState(const gameFrame& frame)
+{
+    metrics::timer t(metrics::stage::Serialize);
+    nlohmann::json state;
+    if (endlessLevel) {
+        state["endless"] = true;
+    }
+    else {
+        state["labyrinth"] = levelRows;
+        state["width"] = level->getWidth();
+        state["height"] = level->getHeight();
+    }
+    state["level"] = levelVersion;
+    state["seq"] = stateSeq;
+
+    if (frame.hasPlayer) {
+        state["player"] = { {"x", frame.playerX}, {"y", frame.playerY} };
+    }
+    if (frame.hasAI) {
+        state["ai"] = { {"x", frame.aiX}, {"y", frame.aiY} };
+    }
+
+    return state.dump();
+}
+
+// {"type":"rows","level":n,"first":y,"width":w,"rows":["# ##",...]}
+std::string roomBroadcaster::jsonRows(const endlessRows& rows) const
+{
+    metrics::timer t(metrics::stage::Serialize);
+    nlohmann::json message;
+    message["type"] = "rows";
+    message["level"] = levelVersion;
+    message["first"] = rows.firstRow;
+    message["width"] = rows.width;
+
+    nlohmann::json list = nlohmann::json::array();
+    for (int y = rows.firstRow; y < rows.endRow(); ++y) {
+        list.push_back(rows.row(y));
+    }
+    message["rows"] = std::move(list);
+    return message.dump();
+}
+
+// {"type":"level","level":n,"width":w,"height":h,"chunk":16,"start":[x,y],"end":[x,y]},
+// with "fog":true in place of "chunk" and no "end" on fog levels
+std::string roomBroadcaster::jsonLevelInfo(int chunkSize) const
+{
+    nlohmann::json info;
+    info["type"] = "level";
+    info["level"] = levelVersion;
+    info["width"] = level->getWidth();
+    info["height"] = level->getHeight();
+    if (chunkSize > 0) info["chunk"] = chunkSize;
+    else info["fog"] = true;
+    info["start"] = { level->getStartX(), level->getStartY() };
+    // Fog levels send E with the reveal that contains it
+    if (chunkSize > 0) info["end"] = { level->getEndX(), level->getEndY() };
+    return info.dump();
+}
+
+// {"type":"reveal","level":n,"open":[cell,...],"walls":[cell,...]}, cell = y * width + x,
+// plus "end":[x,y] once E is among the cells
+std::string roomBroadcaster::jsonReveal(size_t from) const
+{
+    int end = level->inBounds(level->getEndX(), level->getEndY()) ? level->index(level->getEndX(), level->getEndY()) : -1;
+    bool hasEnd = false;
+
+    nlohmann::json open = nlohmann::json::array();
+    nlohmann::json walls = nlohmann::json::array();
+    for (size_t i = from; i < revealed.size(); ++i) {
+        (level->isWall(static_cast<int>(revealed[i])) ? walls : open).push_back(revealed[i]);
+        hasEnd |= static_cast<int>(revealed[i]) == end;
+    }
+
+    nlohmann::json message;
+    message["type"] = "reveal";
+    message["level"] = levelVersion;
+    message["open"] = std::move(open);
+    message["walls"] = std::move(walls);
+    if (hasEnd) message["end"] = { level->getEndX(), level->getEndY() };
+    return message.dump();
+}
+
+// Positions only: {"type":"delta","seq":n,"p":[x,y],"a":[x,y]}
+std::string roomBroadcaster::deltaState(const gameFrame& frame) const
+{
+    metrics::timer t(metrics::stage::Serialize);
+    nlohmann::json delta;
+    delta["type"] = "delta";
+    delta["seq"] = stateSeq;
+
+    if (frame.hasPlayer) {
+        delta["p"] = { frame.playerX, frame.playerY };
+    }
+    if (frame.hasAI) {
+        delta["a"] = { frame.aiX, frame.aiY };
+    }
+
+    return delta.dump();
+}
+
+std::string roomBroadcaster::binaryLevel(const gameFrame& frame) const
+{
+    metrics::timer t(metrics::stage::Serialize);
+    return wire::encodeLevel(*level, static_cast<uint32_t>(levelVersion), static_cast<uint32_t>(stateSeq), toPositions(frame));
+}
+
+std::string roomBroadcaster::binaryUpdate(const gameFrame& frame) const
+{
+    metrics::timer t(metrics::stage::Serialize);
+    return wire::encodePositionUpdate(static_cast<uint32_t>(stateSeq), toPositions(frame));
+}
@@ -0,0 +1,215 @@
+#include "../Declarations/roomManager.hpp"
+#include "../Declarations/logger.hpp"
+#include "../Declarations/metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+
+roomManager::roomManager(unsigned threadCount, mazePoolConfig poolConfig)
+    : signals(context, SIGINT, SIGTERM), mazes(context.get_executor(), poolConfig), threadCount(std::max(1u, threadCount))
+{
+}
+
+roomManager::~roomManager()
+{
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void roomManager::run(uint16_t port)
+{
+    websocketServer.set_reuse_addr(true);
+    websocketServer.init_asio(&context);
+
+    websocketServer.set_open_handler([this](websocketpp::connection_hdl hdl) { onOpen(hdl); });
+    websocketServer.set_close_handler([this](websocketpp::connection_hdl hdl) { onClose(hdl); });
+    websocketServer.set_message_handler([this](websocketpp::connection_hdl hdl, server::message_ptr msg) {
+        onMessage(hdl, msg);
+        });
+    websocketServer.set_http_handler([this](websocketpp::connection_hdl hdl) { onHttp(hdl); });
+
+    websocketServer.listen(port);
+    websocketServer.start_accept();
+
+    signals.async_wait([this](const asio::error_code& ec, int signal) {
+        if (ec) return;
+        LOG_INFO("Stopping on signal", { {"signal", signal} });
+        stop();
+        });
+
+    LOG_INFO("Server is running and ready to accept connections", { {"port", port}, {"threads", threadCount} });
+
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back([this]() { context.run(); });
+    }
+    context.run();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    // Every loop thread is done, so the games can go here; ~Game ends their
+    // recordings. A room a dropped handler still holds goes with the context.
+    std::lock_guard<std::mutex> lock(roomsMutex);
+    connectionRooms.clear();
+    rooms.clear();
+}
+
+void roomManager::stop()
+{
+    asio::error_code ignored;
+    signals.cancel(ignored);
+
+    websocketpp::lib::error_code ec;
+    websocketServer.stop_listening(ec);
+    context.stop();
+}
+
+std::size_t roomManager::roomCount()
+{
+    std::lock_guard<std::mutex> lock(roomsMutex);
+    return rooms.size();
+}
+
+std::string roomManager::roomIdFor(websocketpp::connection_hdl hdl)
+{
+    std::string resource;
+    if (auto con = websocketServer.get_con_from_hdl(hdl)) {
+        resource = con->get_resource();
+    }
+
+    // "/<room>?query" -> "<room>"
+    auto query = resource.find('?');
+    if (query != std::string::npos) resource.erase(query);
+    resource.erase(0, resource.find_first_not_of('/'));
+
+    if (resource.empty()) {
+        return "private-" + std::to_string(nextPrivateRoom++);
+    }
+    return resource;
+}
+
+std::shared_ptr<roomManager::room> roomManager::findOrCreateRoom(const std::string& roomId)
+{
+    auto it = rooms.find(roomId);
+    if (it != rooms.end()) {
+        return it->second;
+    }
+
+    auto r = std::make_shared<room>(asio::make_strand(context));
+    r->id = roomId;
+    r->game = std::make_unique<Game>(websocketServer, r->strand, mazes);
+    rooms.emplace(roomId, r);
+    LOG_INFO("🚪 Opened room", { {"room", roomId} });
+    return r;
+}
+
+void roomManager::onOpen(websocketpp::connection_hdl hdl)
+{
+    std::shared_ptr<room> r;
+    {
+        std::lock_guard<std::mutex> lock(roomsMutex);
+        r = findOrCreateRoom(roomIdFor(hdl));
+        r->members++;
+        connectionRooms[hdl] = r;
+    }
+
+    asio::post(r->strand, [r, hdl]() { r->game->addConnection(hdl); });
+}
+
+void roomManager::onClose(websocketpp::connection_hdl hdl)
+{
+    std::shared_ptr<room> r;
+    bool empty = false;
+    {
+        std::lock_guard<std::mutex> lock(roomsMutex);
+        auto it = connectionRooms.find(hdl);
+        if (it == connectionRooms.end()) return;
+
+        r = it->second;
+        connectionRooms.erase(it);
+        empty = (--r->members == 0);
+        if (empty) {
+            rooms.erase(r->id);
+            auto pool = mazes.snapshot();
+            LOG_INFO("🚪 Closed room", { {"room", r->id}, {"poolHits", pool.hits}, {"libraryHits", pool.libraryHits}, {"poolMisses", pool.misses}, {"poolReady", pool.ready} });
+        }
+    }
+
+    asio::post(r->strand, [r, hdl, empty]() {
+        r->game->removeConnection(hdl);
+        if (empty) {
+            r->game->resetGame();
+        }
+        });
+}
+
+void roomManager::onMessage(websocketpp::connection_hdl hdl, server::message_ptr msg)
+{
+    metrics::add(metrics::counter::MessagesIn);
+    auto received = std::chrono::steady_clock::now();
+
+    std::shared_ptr<room> r;
+    {
+        std::lock_guard<std::mutex> lock(roomsMutex);
+        auto it = connectionRooms.find(hdl);
+        if (it == connectionRooms.end()) {
+            LOG_WARN("⚠️ Message from a connection without a room. Ignoring.");
+            return;
+        }
+        r = it->second;
+    }
+
+    asio::post(r->strand, [r, hdl, msg, received]() {
+        metrics::record(metrics::stage::Receive, std::chrono::steady_clock::now() - received);
+        try {
+            if (msg->get_opcode() == websocketpp::frame::opcode::binary) {
+                r->game->handleBinaryMessage(hdl, msg->get_payload());
+            }
+            else {
+                r->game->handlePlayerMove(hdl, msg->get_payload());
+            }
+        }
+        catch (const std::exception& e) {
+            LOG_ERROR("❌ Room failed to handle message", { {"room", r->id}, {"error", e.what()} });
+        }
+        });
+}
+
+void roomManager::onHttp(websocketpp::connection_hdl hdl)
+{
+    auto con = websocketServer.get_con_from_hdl(hdl);
+    if (!con) return;
+
+    std::string resource = con->get_resource();
+    if (resource != "/metrics") {
+        con->set_status(websocketpp::http::status_code::not_found);
+        con->set_body("Not found\n");
+        return;
+    }
+
+    size_t connections, roomsOpen;
+    {
+        std::lock_guard<std::mutex> lock(roomsMutex);
+        connections = connectionRooms.size();
+        roomsOpen = rooms.size();
+    }
+    auto pool = mazes.snapshot();
+
+    con->set_status(websocketpp::http::status_code::ok);
+    con->replace_header("Content-Type", "text/plain; version=0.0.4");
+    con->set_body(metrics::render({
+        { "labyrinth_connections", "Open WebSocket connections", "gauge", double(connections) },
+        { "labyrinth_rooms", "Open rooms", "gauge", double(roomsOpen) },
+        { "labyrinth_pool_hits_total", "Mazes served from the pool", "counter", double(pool.hits) },
+        { "labyrinth_pool_library_hits_total", "Mazes served from the baked library", "counter", double(pool.libraryHits) },
+        { "labyrinth_pool_misses_total", "Mazes built on demand", "counter", double(pool.misses) },
+        { "labyrinth_pool_generated_total", "Mazes built by pool refills", "counter", double(pool.generated) },
+        { "labyrinth_pool_ready", "Mazes waiting in the pool", "gauge", double(pool.ready) },
+        { "labyrinth_log_dropped_total", "Log records dropped on full rings", "counter", double(logging::droppedCount()) },
+        }));
+}
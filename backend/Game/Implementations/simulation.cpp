@@ -0,0 +1,52 @@
+#include "../Declarations/simulation.hpp"
+#include <chrono>
+
+matchSimulation::matchSimulation(labyrinthMap maze, const std::vector<Difficulty>& difficulties, uint64_t seed)
+    : map(std::move(maze))
+{
+    field.reserve(difficulties.size());
+    for (size_t i = 0; i < difficulties.size(); ++i) {
+        racer r;
+        r.difficulty = difficulties[i];
+        r.player = std::make_shared<Player>(static_cast<int>(i) + 1, 'A', map.getStartX(), map.getStartY());
+        r.ai = std::make_unique<aiController>(r.player, map, r.difficulty, fastRng::splitMix(seed));
+        field.push_back(std::move(r));
+    }
+    running = static_cast<int>(field.size());
+}
+
+int matchSimulation::tick(bool timeMoves)
+{
+    tickCount++;
+    int arrived = 0;
+    for (racer& r : field) {
+        if (r.arrivedAt >= 0) continue;
+
+        if (timeMoves) {
+            auto start = std::chrono::steady_clock::now();
+            r.ai->makeMove();
+            r.timedNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            r.timedMoves++;
+        }
+        else {
+            r.ai->makeMove();
+        }
+        r.moves++;
+
+        if (map.gameOver(*r.player)) {
+            r.arrivedAt = tickCount;
+            arrived++;
+        }
+    }
+    running -= arrived;
+    return arrived;
+}
+
+int matchSimulation::run(int maxTicks, bool timeMoves)
+{
+    int first = -1;
+    while (running > 0 && tickCount < maxTicks) {
+        if (tick(timeMoves) > 0 && first < 0) first = tickCount;
+    }
+    return first;
+}
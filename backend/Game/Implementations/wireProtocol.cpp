@@ -0,0 +1,401 @@
+#include "../Declarations/wireProtocol.hpp"
+#include <algorithm>
+
+namespace
+{
+    const size_t POSITIONS_SIZE = 9;
+    const size_t POSITION_UPDATE_SIZE = 1 + 4 + POSITIONS_SIZE;
+    const size_t LEVEL_HEADER_SIZE = 1 + 4 + 4 + 2 + 2 + 8 + POSITIONS_SIZE;
+    const size_t ROWS_HEADER_SIZE = 1 + 4 + 4 + 2 + 2;
+    const size_t LEVEL_INFO_SIZE = 1 + 4 + 4 + 2 + 2 + 1 + 8 + POSITIONS_SIZE;
+    const size_t CHUNK_HEADER_SIZE = 1 + 4 + 2 + 2;
+    const size_t REVEAL_HEADER_SIZE = 1 + 4 + 4;
+
+    void put8(std::string& out, uint8_t v) { out.push_back(static_cast<char>(v)); }
+    void put16(std::string& out, uint16_t v)
+    {
+        out.push_back(static_cast<char>(v & 0xFF));
+        out.push_back(static_cast<char>(v >> 8));
+    }
+    void put32(std::string& out, uint32_t v)
+    {
+        put16(out, static_cast<uint16_t>(v & 0xFFFF));
+        put16(out, static_cast<uint16_t>(v >> 16));
+    }
+
+    uint8_t get8(std::string_view in, size_t& at) { return static_cast<uint8_t>(in[at++]); }
+    uint16_t get16(std::string_view in, size_t& at)
+    {
+        uint16_t lo = get8(in, at);
+        uint16_t hi = get8(in, at);
+        return static_cast<uint16_t>(lo | (hi << 8));
+    }
+    uint32_t get32(std::string_view in, size_t& at)
+    {
+        uint32_t lo = get16(in, at);
+        uint32_t hi = get16(in, at);
+        return lo | (hi << 16);
+    }
+
+    void putPositions(std::string& out, const wire::positions& pos)
+    {
+        put16(out, pos.playerX);
+        put16(out, pos.playerY);
+        put8(out, pos.hasAI ? 1 : 0);
+        put16(out, pos.aiX);
+        put16(out, pos.aiY);
+    }
+
+    wire::positions toPositions(const Player* player, const Player* ai)
+    {
+        wire::positions pos;
+        if (player) {
+            pos.playerX = static_cast<uint16_t>(player->getX());
+            pos.playerY = static_cast<uint16_t>(player->getY());
+        }
+        if (ai) {
+            pos.hasAI = true;
+            pos.aiX = static_cast<uint16_t>(ai->getX());
+            pos.aiY = static_cast<uint16_t>(ai->getY());
+        }
+        return pos;
+    }
+
+    wire::positions getPositions(std::string_view in, size_t& at)
+    {
+        wire::positions pos;
+        pos.playerX = get16(in, at);
+        pos.playerY = get16(in, at);
+        pos.hasAI = get8(in, at) != 0;
+        pos.aiX = get16(in, at);
+        pos.aiY = get16(in, at);
+        return pos;
+    }
+
+    bool hasType(std::string_view payload, wire::messageType type, size_t minSize)
+    {
+        return payload.size() >= minSize && static_cast<uint8_t>(payload[0]) == static_cast<uint8_t>(type);
+    }
+}
+
+namespace wire
+{
+    std::string encodeMove(int playerId, Player::PlayerDirection direction)
+    {
+        std::string out;
+        put8(out, static_cast<uint8_t>(messageType::MoveInput));
+        put8(out, static_cast<uint8_t>(playerId));
+        put8(out, static_cast<uint8_t>(direction));
+        return out;
+    }
+
+    std::string encodePositionUpdate(uint32_t seq, const positions& pos)
+    {
+        std::string out;
+        out.reserve(POSITION_UPDATE_SIZE);
+        put8(out, static_cast<uint8_t>(messageType::PositionUpdate));
+        put32(out, seq);
+        putPositions(out, pos);
+        return out;
+    }
+
+    std::string encodePositionUpdate(uint32_t seq, const Player* player, const Player* ai)
+    {
+        return encodePositionUpdate(seq, toPositions(player, ai));
+    }
+
+    std::string encodeLevel(const labyrinthMap& map, uint32_t level, uint32_t seq, const Player* player, const Player* ai)
+    {
+        return encodeLevel(map, level, seq, toPositions(player, ai));
+    }
+
+    std::string encodeLevel(const labyrinthMap& map, uint32_t level, uint32_t seq, const positions& pos)
+    {
+        const uint64_t* bits = map.getWallBits();
+        size_t cells = static_cast<size_t>(map.getWidth()) * map.getHeight();
+        size_t bytes = (cells + 7) / 8;
+        auto [endX, endY] = map.getEndPosition();
+
+        std::string out;
+        out.reserve(LEVEL_HEADER_SIZE + bytes);
+        put8(out, static_cast<uint8_t>(messageType::LevelBlob));
+        put32(out, level);
+        put32(out, seq);
+        put16(out, static_cast<uint16_t>(map.getWidth()));
+        put16(out, static_cast<uint16_t>(map.getHeight()));
+        put16(out, static_cast<uint16_t>(map.getStartX()));
+        put16(out, static_cast<uint16_t>(map.getStartY()));
+        put16(out, static_cast<uint16_t>(endX));
+        put16(out, static_cast<uint16_t>(endY));
+        putPositions(out, pos);
+
+        for (size_t i = 0; i < bytes; ++i) {
+            put8(out, static_cast<uint8_t>(bits[i / 8] >> ((i % 8) * 8)));
+        }
+        return out;
+    }
+
+    std::string encodeLevelInfo(const labyrinthMap& map, uint32_t level, uint32_t seq, int chunkSize, const positions& pos)
+    {
+        auto [endX, endY] = map.getEndPosition();
+        if (chunkSize == 0) {
+            // Fog: E goes out with the reveal that contains it
+            endX = endY = 0xFFFF;
+        }
+
+        std::string out;
+        out.reserve(LEVEL_INFO_SIZE);
+        put8(out, static_cast<uint8_t>(messageType::LevelInfo));
+        put32(out, level);
+        put32(out, seq);
+        put16(out, static_cast<uint16_t>(map.getWidth()));
+        put16(out, static_cast<uint16_t>(map.getHeight()));
+        put8(out, static_cast<uint8_t>(chunkSize));
+        put16(out, static_cast<uint16_t>(map.getStartX()));
+        put16(out, static_cast<uint16_t>(map.getStartY()));
+        put16(out, static_cast<uint16_t>(endX));
+        put16(out, static_cast<uint16_t>(endY));
+        putPositions(out, pos);
+        return out;
+    }
+
+    std::string encodeReveal(uint32_t level, const labyrinthMap& map, const uint32_t* cells, size_t count)
+    {
+        std::string out;
+        out.reserve(REVEAL_HEADER_SIZE + count * 4);
+        put8(out, static_cast<uint8_t>(messageType::RevealBlob));
+        put32(out, level);
+        put32(out, static_cast<uint32_t>(count));
+        bool hasEnd = false;
+        uint32_t end = map.inBounds(map.getEndX(), map.getEndY())
+            ? static_cast<uint32_t>(map.index(map.getEndX(), map.getEndY())) : UINT32_MAX;
+        for (size_t i = 0; i < count; ++i) {
+            put32(out, (cells[i] << 1) | (map.isWall(static_cast<int>(cells[i])) ? 1u : 0u));
+            hasEnd |= cells[i] == end;
+        }
+        if (hasEnd) {
+            put16(out, static_cast<uint16_t>(map.getEndX()));
+            put16(out, static_cast<uint16_t>(map.getEndY()));
+        }
+        return out;
+    }
+
+    std::string encodeChunk(const labyrinthMap& map, uint32_t level, int chunkX, int chunkY, int chunkSize)
+    {
+        int x0 = chunkX * chunkSize;
+        int y0 = chunkY * chunkSize;
+        int w = std::min(chunkSize, map.getWidth() - x0);
+        int h = std::min(chunkSize, map.getHeight() - y0);
+
+        std::string out;
+        out.reserve(CHUNK_HEADER_SIZE + (static_cast<size_t>(w) * h + 7) / 8);
+        put8(out, static_cast<uint8_t>(messageType::ChunkBlob));
+        put32(out, level);
+        put16(out, static_cast<uint16_t>(chunkX));
+        put16(out, static_cast<uint16_t>(chunkY));
+
+        uint8_t byte = 0;
+        size_t bit = 0;
+        for (int y = y0; y < y0 + h; ++y) {
+            for (int x = x0; x < x0 + w; ++x, ++bit) {
+                if (map.isWall(x, y)) byte |= static_cast<uint8_t>(1u << (bit % 8));
+                if (bit % 8 == 7) {
+                    put8(out, byte);
+                    byte = 0;
+                }
+            }
+        }
+        if (bit % 8) put8(out, byte);
+        return out;
+    }
+
+    std::string encodeRows(const endlessRows& rows, uint32_t level)
+    {
+        size_t cells = static_cast<size_t>(rows.width) * rows.count();
+
+        std::string out;
+        out.reserve(ROWS_HEADER_SIZE + (cells + 7) / 8);
+        put8(out, static_cast<uint8_t>(messageType::RowsBlob));
+        put32(out, level);
+        put32(out, static_cast<uint32_t>(rows.firstRow));
+        put16(out, static_cast<uint16_t>(rows.width));
+        put16(out, static_cast<uint16_t>(rows.count()));
+
+        // Rows are word-aligned in memory but packed back to back here
+        uint8_t byte = 0;
+        size_t bit = 0;
+        for (int y = rows.firstRow; y < rows.endRow(); ++y) {
+            for (int x = 0; x < rows.width; ++x, ++bit) {
+                if (rows.isWall(x, y)) byte |= static_cast<uint8_t>(1u << (bit % 8));
+                if (bit % 8 == 7) {
+                    put8(out, byte);
+                    byte = 0;
+                }
+            }
+        }
+        if (bit % 8) put8(out, byte);
+        return out;
+    }
+
+    std::string encodeGameOver(int winner)
+    {
+        std::string out;
+        put8(out, static_cast<uint8_t>(messageType::GameOver));
+        put8(out, static_cast<uint8_t>(winner));
+        return out;
+    }
+
+    std::string encodeResync()
+    {
+        return std::string(1, static_cast<char>(messageType::Resync));
+    }
+
+    bool peekType(std::string_view payload, messageType& type)
+    {
+        if (payload.empty()) return false;
+        type = static_cast<messageType>(payload[0]);
+        return true;
+    }
+
+    bool decodeMove(std::string_view payload, moveInput& out)
+    {
+        if (!hasType(payload, messageType::MoveInput, 3)) return false;
+        uint8_t dir = static_cast<uint8_t>(payload[2]);
+        if (dir > static_cast<uint8_t>(Player::PlayerDirection::MoveDown)) return false;
+
+        out.playerId = static_cast<uint8_t>(payload[1]);
+        out.direction = static_cast<Player::PlayerDirection>(dir);
+        return true;
+    }
+
+    bool decodePositionUpdate(std::string_view payload, positionUpdate& out)
+    {
+        if (!hasType(payload, messageType::PositionUpdate, POSITION_UPDATE_SIZE)) return false;
+        size_t at = 1;
+        out.seq = get32(payload, at);
+        out.pos = getPositions(payload, at);
+        return true;
+    }
+
+    bool decodeLevel(std::string_view payload, levelBlob& out)
+    {
+        if (!hasType(payload, messageType::LevelBlob, LEVEL_HEADER_SIZE)) return false;
+        size_t at = 1;
+        out.level = get32(payload, at);
+        out.seq = get32(payload, at);
+        out.width = get16(payload, at);
+        out.height = get16(payload, at);
+        out.startX = get16(payload, at);
+        out.startY = get16(payload, at);
+        out.endX = get16(payload, at);
+        out.endY = get16(payload, at);
+        out.pos = getPositions(payload, at);
+
+        size_t cells = static_cast<size_t>(out.width) * out.height;
+        if (payload.size() < at + (cells + 7) / 8) return false;
+        if (out.startX >= out.width || out.startY >= out.height || out.endX >= out.width || out.endY >= out.height) return false;
+
+        out.rows.assign(out.height, std::string(out.width, ' '));
+        for (size_t cell = 0; cell < cells; ++cell) {
+            uint8_t byte = static_cast<uint8_t>(payload[at + cell / 8]);
+            if ((byte >> (cell % 8)) & 1) {
+                out.rows[cell / out.width][cell % out.width] = labyrinthMap::WALL;
+            }
+        }
+        out.rows[out.startY][out.startX] = 'S';
+        out.rows[out.endY][out.endX] = 'E';
+        return true;
+    }
+
+    bool decodeLevelInfo(std::string_view payload, levelInfo& out)
+    {
+        if (!hasType(payload, messageType::LevelInfo, LEVEL_INFO_SIZE)) return false;
+        size_t at = 1;
+        out.level = get32(payload, at);
+        out.seq = get32(payload, at);
+        out.width = get16(payload, at);
+        out.height = get16(payload, at);
+        out.chunkSize = get8(payload, at);
+        out.startX = get16(payload, at);
+        out.startY = get16(payload, at);
+        out.endX = get16(payload, at);
+        out.endY = get16(payload, at);
+        out.pos = getPositions(payload, at);
+        return true;
+    }
+
+    bool decodeReveal(std::string_view payload, revealBlob& out)
+    {
+        if (!hasType(payload, messageType::RevealBlob, REVEAL_HEADER_SIZE)) return false;
+        size_t at = 1;
+        out.level = get32(payload, at);
+        uint32_t count = get32(payload, at);
+        if ((payload.size() - at) / 4 < count) return false;
+
+        out.entries.resize(count);
+        for (uint32_t& entry : out.entries) entry = get32(payload, at);
+
+        out.hasEnd = payload.size() - at >= 4;
+        if (out.hasEnd) {
+            out.endX = get16(payload, at);
+            out.endY = get16(payload, at);
+        }
+        return true;
+    }
+
+    bool decodeChunk(std::string_view payload, const levelInfo& info, chunkBlob& out)
+    {
+        if (!hasType(payload, messageType::ChunkBlob, CHUNK_HEADER_SIZE) || info.chunkSize == 0) return false;
+        size_t at = 1;
+        out.level = get32(payload, at);
+        out.chunkX = get16(payload, at);
+        out.chunkY = get16(payload, at);
+
+        int x0 = out.chunkX * info.chunkSize;
+        int y0 = out.chunkY * info.chunkSize;
+        if (x0 >= info.width || y0 >= info.height) return false;
+        int w = std::min<int>(info.chunkSize, info.width - x0);
+        int h = std::min<int>(info.chunkSize, info.height - y0);
+
+        size_t cells = static_cast<size_t>(w) * h;
+        if (payload.size() < at + (cells + 7) / 8) return false;
+
+        out.rows.assign(h, std::string(w, ' '));
+        for (size_t cell = 0; cell < cells; ++cell) {
+            uint8_t byte = static_cast<uint8_t>(payload[at + cell / 8]);
+            if ((byte >> (cell % 8)) & 1) {
+                out.rows[cell / w][cell % w] = labyrinthMap::WALL;
+            }
+        }
+        return true;
+    }
+
+    bool decodeRows(std::string_view payload, rowsBlob& out)
+    {
+        if (!hasType(payload, messageType::RowsBlob, ROWS_HEADER_SIZE)) return false;
+        size_t at = 1;
+        out.level = get32(payload, at);
+        out.firstRow = get32(payload, at);
+        out.width = get16(payload, at);
+        uint16_t count = get16(payload, at);
+
+        size_t cells = static_cast<size_t>(out.width) * count;
+        if (payload.size() < at + (cells + 7) / 8) return false;
+
+        out.rows.assign(count, std::string(out.width, ' '));
+        for (size_t cell = 0; cell < cells; ++cell) {
+            uint8_t byte = static_cast<uint8_t>(payload[at + cell / 8]);
+            if ((byte >> (cell % 8)) & 1) {
+                out.rows[cell / out.width][cell % out.width] = labyrinthMap::WALL;
+            }
+        }
+        return true;
+    }
+
+    bool decodeGameOver(std::string_view payload, int& winner)
+    {
+        if (!hasType(payload, messageType::GameOver, 2)) return false;
+        winner = static_cast<uint8_t>(payload[1]);
+        return true;
+    }
+}
@@ -0,0 +1,236 @@
+// Headless AI-vs-AI batch simulation for tuning. Every match races one AI per
+// listed difficulty on a freshly generated maze until all of them reach E (or
+// --max-ticks runs out), on every core, with no server and no step delays.
+// Reports win rates, steps to goal and CPU per move for each difficulty.
+//
+//     BatchSim [--games 10000] [--threads N] [--size 21] [--racers easy,medium,hard]
+//              [--max-ticks N] [--mazes-per 1] [--time-every 16] [--seed S]
+//
+// --mazes-per K replays each generated maze K times, so generation does not
+// dominate short matches. --time-every N times the moves of one match in N
+// (0 turns timing off). Every maze and race derives from --seed (printed when
+// drawn), so a run can be repeated exactly with any thread count.
+#include "../Game/Declarations/Difficulty.hpp"
+#include "../Game/Declarations/fastRng.hpp"
+#include "../Game/Declarations/labyrinth.hpp"
+#include "../Game/Declarations/logger.hpp"
+#include "../Game/Declarations/simulation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct options
+    {
+        uint64_t games = 10000;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        int size = 21;
+        std::vector<Difficulty> racers{ EASY, MEDIUM, HARD };
+        int maxTicks = 0;          // 0: 20 * size * size
+        int mazesPer = 1;
+        int timeEvery = 16;
+        uint64_t seed = fastRng::freshSeed();
+    };
+
+    // Independent child seed `n` of `base`
+    uint64_t derive(uint64_t base, uint64_t n, uint64_t stream)
+    {
+        uint64_t x = base ^ (stream * 0xd1b54a32d192ed03ULL);
+        x += n * 0x9e3779b97f4a7c15ULL;
+        return fastRng::splitMix(x);
+    }
+
+    // Per racer slot; each worker fills its own and they are merged at the end
+    struct racerStats
+    {
+        uint64_t wins = 0;         // Arrived first, alone
+        uint64_t ties = 0;         // Arrived first, with others
+        uint64_t timeouts = 0;
+        uint64_t moves = 0;
+        uint64_t timedMoves = 0;
+        uint64_t timedNanos = 0;
+        std::vector<int> steps;    // Tick of arrival, per finished match
+    };
+
+    struct workerStats
+    {
+        std::vector<racerStats> racers;
+        uint64_t games = 0;
+        uint64_t generateNanos = 0;
+    };
+
+    const char* difficultyName(Difficulty difficulty)
+    {
+        switch (difficulty) {
+        case EASY: return "easy";
+        case MEDIUM: return "medium";
+        case HARD: return "hard";
+        }
+        return "?";
+    }
+
+    bool parseRacers(const std::string& list, std::vector<Difficulty>& out)
+    {
+        out.clear();
+        std::stringstream in(list);
+        std::string name;
+        while (std::getline(in, name, ',')) {
+            if (name == "easy") out.push_back(EASY);
+            else if (name == "medium") out.push_back(MEDIUM);
+            else if (name == "hard") out.push_back(HARD);
+            else return false;
+        }
+        return !out.empty();
+    }
+
+    void runWorker(const options& opts, std::atomic<uint64_t>& nextGame, workerStats& stats)
+    {
+        stats.racers.resize(opts.racers.size());
+        std::unique_ptr<labyrinthMap> maze;
+        uint64_t mazeIndex = UINT64_MAX;
+
+        while (true) {
+            uint64_t game = nextGame.fetch_add(1, std::memory_order_relaxed);
+            if (game >= opts.games) return;
+
+            // Games share mazes by index, not by worker, so results don't
+            // depend on scheduling
+            if (game / opts.mazesPer != mazeIndex) {
+                mazeIndex = game / opts.mazesPer;
+                auto start = std::chrono::steady_clock::now();
+                maze = std::make_unique<labyrinthMap>(opts.size, opts.size);
+                maze->generateLabyrinth(derive(opts.seed, mazeIndex, 1));
+                stats.generateNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            }
+
+            // Each match gets its own view of the grid, so goal distances and
+            // player state never leak between matches
+            labyrinthMap copy(maze->getWidth(), maze->getHeight(), maze->getStartX(), maze->getStartY(),
+                maze->getEndX(), maze->getEndY(), maze->getWallBits(), nullptr);
+
+            bool timed = opts.timeEvery > 0 && game % opts.timeEvery == 0;
+            matchSimulation match(std::move(copy), opts.racers, derive(opts.seed, game, 2));
+            int first = match.run(opts.maxTicks, timed);
+
+            int firstCount = 0;
+            for (const auto& r : match.racers()) {
+                if (first >= 0 && r.arrivedAt == first) firstCount++;
+            }
+
+            for (size_t i = 0; i < match.racers().size(); ++i) {
+                const auto& r = match.racers()[i];
+                racerStats& s = stats.racers[i];
+                s.moves += r.moves;
+                s.timedMoves += r.timedMoves;
+                s.timedNanos += r.timedNanos;
+                if (r.arrivedAt < 0) {
+                    s.timeouts++;
+                    continue;
+                }
+                s.steps.push_back(r.arrivedAt);
+                if (r.arrivedAt == first) {
+                    if (firstCount == 1) s.wins++;
+                    else s.ties++;
+                }
+            }
+            stats.games++;
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, options& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            if (arg == "--games") opts.games = std::strtoull(value.c_str(), nullptr, 10);
+            else if (arg == "--threads") opts.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+            else if (arg == "--size") opts.size = std::atoi(value.c_str());
+            else if (arg == "--racers") { if (!parseRacers(value, opts.racers)) return false; }
+            else if (arg == "--max-ticks") opts.maxTicks = std::atoi(value.c_str());
+            else if (arg == "--mazes-per") opts.mazesPer = std::atoi(value.c_str());
+            else if (arg == "--time-every") opts.timeEvery = std::atoi(value.c_str());
+            else if (arg == "--seed") opts.seed = std::strtoull(value.c_str(), nullptr, 10);
+            else return false;
+        }
+        if (opts.maxTicks <= 0) opts.maxTicks = 20 * opts.size * opts.size;
+        return opts.games > 0 && opts.threads > 0 && opts.size >= 3 && opts.mazesPer > 0 && opts.timeEvery >= 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        std::cerr << "usage: " << argv[0] << " [--games N] [--threads N] [--size N] [--racers easy,medium,hard]\n"
+            << "       [--max-ticks N] [--mazes-per K] [--time-every N] [--seed S]\n";
+        return 1;
+    }
+    logging::setLevel(logging::level::Warn);
+
+    std::atomic<uint64_t> nextGame{ 0 };
+    std::vector<workerStats> perWorker(opts.threads);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < opts.threads; ++t) {
+        workers.emplace_back(runWorker, std::cref(opts), std::ref(nextGame), std::ref(perWorker[t]));
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    workerStats total;
+    total.racers.resize(opts.racers.size());
+    for (const workerStats& w : perWorker) {
+        total.games += w.games;
+        total.generateNanos += w.generateNanos;
+        for (size_t i = 0; i < w.racers.size(); ++i) {
+            racerStats& s = total.racers[i];
+            s.wins += w.racers[i].wins;
+            s.ties += w.racers[i].ties;
+            s.timeouts += w.racers[i].timeouts;
+            s.moves += w.racers[i].moves;
+            s.timedMoves += w.racers[i].timedMoves;
+            s.timedNanos += w.racers[i].timedNanos;
+            s.steps.insert(s.steps.end(), w.racers[i].steps.begin(), w.racers[i].steps.end());
+        }
+    }
+
+    uint64_t moves = 0;
+    for (const racerStats& s : total.racers) moves += s.moves;
+
+    std::cout << total.games << " games on " << opts.size << "x" << opts.size << " mazes, " << opts.threads
+        << " threads, seed " << opts.seed << ", " << std::fixed << std::setprecision(2) << seconds << " s ("
+        << std::setprecision(0) << total.games / seconds << " games/s, " << moves / seconds << " moves/s)\n"
+        << "maze generation " << std::setprecision(1) << total.generateNanos / 1e6 << " ms CPU\n\n";
+
+    std::cout << std::left << std::setw(8) << "racer" << std::right << std::setw(9) << "win %" << std::setw(9) << "tie %"
+        << std::setw(11) << "timeouts" << std::setw(10) << "steps p50" << std::setw(10) << "p90" << std::setw(10) << "mean"
+        << std::setw(12) << "ns/move" << "\n";
+    for (size_t i = 0; i < total.racers.size(); ++i) {
+        racerStats& s = total.racers[i];
+        std::sort(s.steps.begin(), s.steps.end());
+        auto at = [&](double q) { return s.steps.empty() ? 0 : s.steps[std::min(s.steps.size() - 1, static_cast<size_t>(q * s.steps.size()))]; };
+        double mean = 0;
+        for (int steps : s.steps) mean += steps;
+        if (!s.steps.empty()) mean /= s.steps.size();
+
+        std::cout << std::left << std::setw(8) << difficultyName(opts.racers[i]) << std::right << std::setprecision(1)
+            << std::setw(9) << 100.0 * s.wins / total.games << std::setw(9) << 100.0 * s.ties / total.games
+            << std::setw(11) << s.timeouts << std::setw(10) << at(0.5) << std::setw(10) << at(0.9)
+            << std::setw(10) << mean << std::setw(12)
+            << (s.timedMoves ? static_cast<double>(s.timedNanos) / s.timedMoves : 0.0) << "\n";
+    }
+
+    logging::flush();
+    return 0;
+}
@@ -0,0 +1,453 @@
+// Headless load generator for the game server. Each simulated client opens a
+// WebSocket, sends a config, then walks the shortest path of every level it
+// receives at a fixed move rate, speaking the same JSON, delta or binary
+// protocol as the app. A move's round trip ends when a state update shows
+// the player on the target cell. Clients start over after gameOver.
+//
+//     LoadGen [--uri ws://localhost:9002] [--clients 100] [--rate 10]
+//             [--seconds 10] [--protocol json|delta|binary]
+//             [--mode single|local] [--difficulty easy|medium|hard]
+//             [--rooms 0] [--threads 1]
+//
+// --rooms 0 gives every client a private room; --rooms K spreads clients
+// over K shared rooms to exercise broadcast fan-out. --threads splits the
+// clients over independent event loops.
+#include <websocketpp/config/asio_no_tls_client.hpp>
+#include <websocketpp/client.hpp>
+#include <asio.hpp>
+
+#include "../Game/Declarations/labyrinth.hpp"
+#include "../Game/Declarations/logger.hpp"
+#include "../Game/Declarations/pathFinder.hpp"
+#include "../Game/Declarations/wireProtocol.hpp"
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef websocketpp::client<websocketpp::config::asio_client> client;
+typedef std::chrono::steady_clock clock_type;
+
+namespace
+{
+    struct settings
+    {
+        std::string uri = "ws://localhost:9002";
+        int clients = 100;
+        double rate = 10;          // Moves per second per client
+        double seconds = 10;
+        std::string protocol = "json";
+        std::string mode = "single";
+        std::string difficulty = "easy";
+        int rooms = 0;
+        unsigned threads = 1;
+    };
+
+    struct stats
+    {
+        std::vector<double> connectUs;
+        std::vector<double> roundTripUs;
+        uint64_t connected = 0;
+        uint64_t failed = 0;
+        uint64_t movesSent = 0;
+        uint64_t lateTicks = 0;    // Previous move still unanswered at the next tick
+        uint64_t stalled = 0;      // Moves with no matching update after a second
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+        uint64_t levels = 0;
+        uint64_t wins = 0;
+        uint64_t losses = 0;
+        uint64_t missingGameOver = 0;   // Reached E but no gameOver followed
+
+        void merge(const stats& other)
+        {
+            connectUs.insert(connectUs.end(), other.connectUs.begin(), other.connectUs.end());
+            roundTripUs.insert(roundTripUs.end(), other.roundTripUs.begin(), other.roundTripUs.end());
+            connected += other.connected;
+            failed += other.failed;
+            movesSent += other.movesSent;
+            lateTicks += other.lateTicks;
+            stalled += other.stalled;
+            messages += other.messages;
+            bytes += other.bytes;
+            levels += other.levels;
+            wins += other.wins;
+            losses += other.losses;
+            missingGameOver += other.missingGameOver;
+        }
+    };
+
+    double microsSince(clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+    }
+
+    class simulatedClient : public std::enable_shared_from_this<simulatedClient>
+    {
+    private:
+        client& endpoint;
+        const settings& config;
+        stats& totals;
+        std::string uri;
+
+        websocketpp::connection_hdl hdl;
+        asio::steady_timer ticker;
+        clock_type::time_point connectStart;
+        bool open = false;
+
+        labyrinthMap map;
+        bool hasLevel = false;
+        int level = -1;
+        pathFinder finder;
+        std::vector<int> path;
+        size_t nextStep = 0;
+        int playerX = 0, playerY = 0;
+
+        bool awaiting = false;
+        int expectX = 0, expectY = 0;
+        clock_type::time_point sentAt;
+        bool reachedGoal = false;
+        clock_type::time_point goalAt;
+
+        void sendText(const std::string& text)
+        {
+            websocketpp::lib::error_code ec;
+            endpoint.send(hdl, text, websocketpp::frame::opcode::text, ec);
+        }
+
+        void sendConfig()
+        {
+            nlohmann::json message;
+            message["type"] = "config";
+            message["mode"] = config.mode;
+            message["difficulty"] = config.difficulty;
+            message["protocol"] = config.protocol;
+            sendText(message.dump());
+
+            hasLevel = false;
+            awaiting = false;
+            reachedGoal = false;
+        }
+
+        void loadLevel(int newLevel, std::vector<std::string>&& rows, int width, int height)
+        {
+            map.setLabyrinthData(std::move(rows), width, height);
+            level = newLevel;
+            hasLevel = true;
+            awaiting = false;
+            reachedGoal = false;
+            totals.levels++;
+            plan();
+        }
+
+        void plan()
+        {
+            auto [endX, endY] = map.getEndPosition();
+            path.clear();
+            nextStep = 1;
+            if (map.inBounds(playerX, playerY)) {
+                finder.findPath(map, map.index(playerX, playerY), map.index(endX, endY), path);
+            }
+        }
+
+        void onPosition(int x, int y)
+        {
+            playerX = x;
+            playerY = y;
+
+            if (awaiting && x == expectX && y == expectY) {
+                totals.roundTripUs.push_back(microsSince(sentAt));
+                awaiting = false;
+                nextStep++;
+            }
+
+            auto [endX, endY] = map.getEndPosition();
+            if (hasLevel && x == endX && y == endY && !reachedGoal) {
+                reachedGoal = true;
+                goalAt = clock_type::now();
+            }
+        }
+
+        void onGameOver(int winner)
+        {
+            if (winner == 1) totals.wins++;
+            else totals.losses++;
+            // Play again, as the app does
+            sendConfig();
+        }
+
+        void onText(const std::string& payload)
+        {
+            auto message = nlohmann::json::parse(payload, nullptr, false);
+            if (message.is_discarded()) return;
+
+            std::string type = message.value("type", "");
+            if (type == "gameOver") {
+                onGameOver(message.value("winner", 0));
+                return;
+            }
+            if (type == "delta") {
+                if (message.contains("p")) onPosition(message["p"][0], message["p"][1]);
+                return;
+            }
+            if (message.contains("labyrinth")) {
+                if (message.contains("player")) {
+                    playerX = message["player"].value("x", 0);
+                    playerY = message["player"].value("y", 0);
+                }
+                int newLevel = message.value("level", 0);
+                if (!hasLevel || newLevel != level) {
+                    loadLevel(newLevel, message["labyrinth"].get<std::vector<std::string>>(),
+                        message.value("width", 0), message.value("height", 0));
+                }
+                if (message.contains("player")) onPosition(playerX, playerY);
+            }
+        }
+
+        void onBinary(const std::string& payload)
+        {
+            wire::messageType type;
+            if (!wire::peekType(payload, type)) return;
+
+            switch (type) {
+            case wire::messageType::LevelBlob: {
+                wire::levelBlob blob;
+                if (!wire::decodeLevel(payload, blob)) return;
+                playerX = blob.pos.playerX;
+                playerY = blob.pos.playerY;
+                if (!hasLevel || static_cast<int>(blob.level) != level) {
+                    loadLevel(static_cast<int>(blob.level), std::move(blob.rows), blob.width, blob.height);
+                }
+                onPosition(blob.pos.playerX, blob.pos.playerY);
+                break;
+            }
+            case wire::messageType::PositionUpdate: {
+                wire::positionUpdate update;
+                if (wire::decodePositionUpdate(payload, update)) onPosition(update.pos.playerX, update.pos.playerY);
+                break;
+            }
+            case wire::messageType::GameOver: {
+                int winner;
+                if (wire::decodeGameOver(payload, winner)) onGameOver(winner);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        void tick()
+        {
+            if (!open) return;
+
+            if (reachedGoal && microsSince(goalAt) > 1e6) {
+                // The server should have ended the game by now
+                totals.missingGameOver++;
+                sendConfig();
+            }
+            else if (awaiting && microsSince(sentAt) > 1e6) {
+                totals.stalled++;
+                awaiting = false;
+                plan();
+            }
+            else if (awaiting) {
+                totals.lateTicks++;
+            }
+            else if (hasLevel && !reachedGoal && nextStep < path.size()) {
+                int target = path[nextStep];
+                Player::PlayerDirection dir = pathFinder::directionBetween(map, path[nextStep - 1], target);
+                expectX = target % map.getWidth();
+                expectY = target / map.getWidth();
+
+                if (config.protocol == "binary") {
+                    std::string frame = wire::encodeMove(1, dir);
+                    websocketpp::lib::error_code ec;
+                    endpoint.send(hdl, frame, websocketpp::frame::opcode::binary, ec);
+                }
+                else {
+                    const char* actions[] = { "left", "right", "up", "down" };   // PlayerDirection order
+                    sendText(nlohmann::json{ {"playerId", 1}, {"action", actions[static_cast<int>(dir)]} }.dump());
+                }
+                sentAt = clock_type::now();
+                awaiting = true;
+                totals.movesSent++;
+            }
+
+            schedule();
+        }
+
+        void schedule()
+        {
+            ticker.expires_after(std::chrono::microseconds(static_cast<int64_t>(1e6 / config.rate)));
+            ticker.async_wait([self = shared_from_this()](const asio::error_code& ec) {
+                if (!ec) self->tick();
+                });
+        }
+
+    public:
+        simulatedClient(client& endpoint, asio::io_context& context, const settings& config, stats& totals, std::string uri)
+            : endpoint(endpoint), config(config), totals(totals), uri(std::move(uri)), ticker(context)
+        {
+        }
+
+        void start()
+        {
+            websocketpp::lib::error_code ec;
+            client::connection_ptr con = endpoint.get_connection(uri, ec);
+            if (ec) {
+                totals.failed++;
+                return;
+            }
+
+            auto self = shared_from_this();
+            con->set_open_handler([self](websocketpp::connection_hdl) {
+                self->totals.connectUs.push_back(microsSince(self->connectStart));
+                self->totals.connected++;
+                self->open = true;
+                self->sendConfig();
+                self->schedule();
+                });
+            con->set_fail_handler([self](websocketpp::connection_hdl) { self->totals.failed++; });
+            con->set_close_handler([self](websocketpp::connection_hdl) {
+                self->open = false;
+                self->ticker.cancel();
+                });
+            con->set_message_handler([self](websocketpp::connection_hdl, client::message_ptr msg) {
+                self->totals.messages++;
+                self->totals.bytes += msg->get_payload().size();
+                if (msg->get_opcode() == websocketpp::frame::opcode::binary) self->onBinary(msg->get_payload());
+                else self->onText(msg->get_payload());
+                });
+
+            hdl = con->get_handle();
+            connectStart = clock_type::now();
+            endpoint.connect(con);
+        }
+
+        void stop()
+        {
+            ticker.cancel();
+            if (!open) return;
+            websocketpp::lib::error_code ec;
+            endpoint.close(hdl, websocketpp::close::status::going_away, "load test done", ec);
+        }
+    };
+
+    // One event loop and client endpoint per thread; nothing is shared
+    void runShard(const settings& config, int first, int count, stats& totals)
+    {
+        asio::io_context context;
+        client endpoint;
+        endpoint.clear_access_channels(websocketpp::log::alevel::all);
+        endpoint.clear_error_channels(websocketpp::log::elevel::all);
+        endpoint.init_asio(&context);
+
+        std::vector<std::shared_ptr<simulatedClient>> clients;
+        for (int i = first; i < first + count; ++i) {
+            std::string uri = config.uri + "/";
+            if (config.rooms > 0) uri += "load-" + std::to_string(i % config.rooms);
+            clients.push_back(std::make_shared<simulatedClient>(endpoint, context, config, totals, uri));
+            clients.back()->start();
+        }
+
+        asio::steady_timer deadline(context);
+        deadline.expires_after(std::chrono::milliseconds(static_cast<int64_t>(config.seconds * 1000)));
+        deadline.async_wait([&](const asio::error_code&) {
+            for (auto& c : clients) c->stop();
+            // Give close handshakes a moment, then stop regardless
+            deadline.expires_after(std::chrono::milliseconds(500));
+            deadline.async_wait([&](const asio::error_code&) { context.stop(); });
+            });
+
+        context.run();
+    }
+
+    void printPercentiles(const char* name, std::vector<double>& samples)
+    {
+        std::cout << std::left << std::setw(18) << name;
+        if (samples.empty()) {
+            std::cout << "no samples\n";
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto at = [&](double q) { return samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))] / 1000.0; };
+        std::cout << std::fixed << std::setprecision(3)
+            << "p50 " << at(0.50) << " ms  p90 " << at(0.90) << " ms  p99 " << at(0.99)
+            << " ms  p99.9 " << at(0.999) << " ms  max " << samples.back() / 1000.0 << " ms  (n=" << samples.size() << ")\n";
+    }
+
+    bool parseArgs(int argc, char** argv, settings& config)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            if (arg == "--uri") config.uri = value;
+            else if (arg == "--clients") config.clients = std::atoi(value.c_str());
+            else if (arg == "--rate") config.rate = std::atof(value.c_str());
+            else if (arg == "--seconds") config.seconds = std::atof(value.c_str());
+            else if (arg == "--protocol") config.protocol = value;
+            else if (arg == "--mode") config.mode = value;
+            else if (arg == "--difficulty") config.difficulty = value;
+            else if (arg == "--rooms") config.rooms = std::atoi(value.c_str());
+            else if (arg == "--threads") config.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+            else return false;
+        }
+        if (!config.uri.empty() && config.uri.back() == '/') config.uri.pop_back();
+        return config.clients > 0 && config.rate > 0 && config.seconds > 0 && config.threads > 0 &&
+            (config.protocol == "json" || config.protocol == "delta" || config.protocol == "binary");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    settings config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "usage: " << argv[0] << " [--uri ws://host:port] [--clients N] [--rate moves/s] [--seconds N]\n"
+            << "       [--protocol json|delta|binary] [--mode single|local] [--difficulty easy|medium|hard]\n"
+            << "       [--rooms K] [--threads N]\n";
+        return 1;
+    }
+    logging::setLevel(logging::level::Warn);
+
+    std::cout << "Driving " << config.uri << " with " << config.clients << " clients at " << config.rate
+        << " moves/s for " << config.seconds << " s (" << config.protocol << ", " << config.mode << ")\n";
+
+    unsigned threads = std::min<unsigned>(config.threads, static_cast<unsigned>(config.clients));
+    std::vector<stats> shardStats(threads);
+    std::vector<std::thread> workers;
+    auto start = clock_type::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        int first = static_cast<int>(config.clients * t / threads);
+        int last = static_cast<int>(config.clients * (t + 1) / threads);
+        workers.emplace_back(runShard, std::cref(config), first, last - first, std::ref(shardStats[t]));
+    }
+    for (auto& worker : workers) worker.join();
+    double elapsed = microsSince(start) / 1e6;
+
+    stats totals;
+    for (const stats& s : shardStats) totals.merge(s);
+
+    std::cout << "\nconnections       " << totals.connected << " open, " << totals.failed << " failed\n";
+    printPercentiles("connect", totals.connectUs);
+    printPercentiles("move round trip", totals.roundTripUs);
+    std::cout << std::fixed << std::setprecision(1)
+        << "moves             " << totals.movesSent << " sent, " << totals.roundTripUs.size() << " acknowledged ("
+        << totals.roundTripUs.size() / elapsed << "/s), " << totals.lateTicks << " late ticks, " << totals.stalled << " stalled\n"
+        << "server messages   " << totals.messages << " (" << totals.messages / elapsed << "/s, "
+        << totals.bytes / elapsed / 1024.0 << " KiB/s)\n"
+        << "levels            " << totals.levels << " received\n"
+        << "games             " << totals.wins << " won, " << totals.losses << " lost, "
+        << totals.missingGameOver << " without gameOver\n";
+
+    logging::flush();
+    return totals.failed == 0 && totals.missingGameOver == 0 ? 0 : 2;
+}
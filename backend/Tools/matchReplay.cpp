@@ -0,0 +1,183 @@
+// Re-simulates recorded matches (LABYRINTH_RECORD) against labyrinthMap as
+// fast as it can. Every recorded move is applied to the recorded maze and its
+// result compared with the position the server computed, and every win with
+// the player that actually reached E, so divergences show up as errors.
+//
+//     MatchReplay <recording.lbmr> [--repeat N] [--match id] [--verbose]
+//
+// Events are decoded once; --repeat reruns the simulation for benchmarking.
+#include "../Game/Declarations/labyrinth.hpp"
+#include "../Game/Declarations/logger.hpp"
+#include "../Game/Declarations/matchRecorder.hpp"
+#include "../Game/Declarations/player.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct options
+    {
+        std::string path;
+        int repeat = 1;
+        uint64_t onlyMatch = 0;
+        bool verbose = false;
+    };
+
+    struct recordedMatch
+    {
+        uint64_t id;
+        std::vector<recording::matchEvent> events;
+    };
+
+    struct outcome
+    {
+        uint64_t levels = 0;
+        uint64_t moves = 0;
+        uint64_t wins = 0;
+        uint64_t divergedMoves = 0;
+        uint64_t divergedWins = 0;
+        uint64_t recordedMicros = 0;
+    };
+
+    // Plays one match through, printing divergences when asked to
+    void replay(const recordedMatch& match, outcome& result, bool report)
+    {
+        std::unique_ptr<labyrinthMap> map;
+        std::map<int, Player> players;
+        int reachedGoal = 0;
+
+        for (const recording::matchEvent& e : match.events) {
+            switch (e.type) {
+            case recording::eventType::Level:
+                // Borrow the decoded grid; the events outlive this replay
+                map = std::make_unique<labyrinthMap>(e.width, e.height, e.startX, e.startY, e.endX, e.endY,
+                    e.walls.data(), nullptr);
+                players.clear();
+                for (const auto& p : e.players) {
+                    players.emplace(p.id, Player(p.id, p.id == 1 ? 'P' : 'A', p.x, p.y));
+                }
+                reachedGoal = 0;
+                result.levels++;
+                break;
+
+            case recording::eventType::Move: {
+                result.moves++;
+                auto it = players.find(e.playerId);
+                if (!map || it == players.end()) {
+                    result.divergedMoves++;
+                    break;
+                }
+
+                Player& player = it->second;
+                map->setPlayerPosition(player, e.direction);
+                if (player.getX() != e.x || player.getY() != e.y) {
+                    result.divergedMoves++;
+                    if (report) {
+                        std::cout << "match " << match.id << " @" << e.micros << "us: player " << e.playerId
+                            << " replayed to (" << player.getX() << "," << player.getY() << "), recorded ("
+                            << e.x << "," << e.y << ")\n";
+                    }
+                    player.setPosition(e.x, e.y);   // Follow the recording from here on
+                }
+                if (!reachedGoal && map->gameOver(player)) reachedGoal = e.playerId;
+                break;
+            }
+
+            case recording::eventType::Win:
+                result.wins++;
+                if (e.playerId != reachedGoal) {
+                    result.divergedWins++;
+                    if (report) {
+                        std::cout << "match " << match.id << ": recorded winner " << e.playerId
+                            << ", replay winner " << reachedGoal << "\n";
+                    }
+                }
+                break;
+
+            case recording::eventType::Match:
+            case recording::eventType::End:
+                break;
+            }
+        }
+
+        if (!match.events.empty()) result.recordedMicros += match.events.back().micros;
+    }
+
+    bool parseArgs(int argc, char** argv, options& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--verbose") opts.verbose = true;
+            else if (arg == "--repeat" && i + 1 < argc) opts.repeat = std::atoi(argv[++i]);
+            else if (arg == "--match" && i + 1 < argc) opts.onlyMatch = std::strtoull(argv[++i], nullptr, 10);
+            else if (opts.path.empty() && arg[0] != '-') opts.path = arg;
+            else return false;
+        }
+        return !opts.path.empty() && opts.repeat > 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        std::cerr << "usage: " << argv[0] << " <recording.lbmr> [--repeat N] [--match id] [--verbose]\n";
+        return 1;
+    }
+    logging::setLevel(logging::level::Warn);
+
+    std::map<uint64_t, std::string> raw;
+    uint16_t version;
+    std::set<uint64_t> dropped;
+    if (!recording::readFile(opts.path, raw, version, dropped)) {
+        logging::flush();
+        return 1;
+    }
+
+    std::vector<recordedMatch> matches;
+    uint64_t malformed = 0;
+    for (const auto& [id, events] : raw) {
+        if (opts.onlyMatch && id != opts.onlyMatch) continue;
+
+        recordedMatch match{ id, {} };
+        recording::eventReader reader(events, version);
+        recording::matchEvent e;
+        while (reader.next(e)) match.events.push_back(e);
+        if (reader.failed()) {
+            malformed++;
+            std::cout << "match " << id << ": malformed after " << match.events.size() << " events\n";
+        }
+        matches.push_back(std::move(match));
+    }
+
+    outcome first;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < opts.repeat; ++round) {
+        outcome result;
+        for (const recordedMatch& match : matches) {
+            replay(match, result, opts.verbose && round == 0);
+        }
+        if (round == 0) first = result;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double simulated = first.recordedMicros / 1e6 * opts.repeat;
+    std::cout << "Replayed " << matches.size() << " matches x" << opts.repeat << ": "
+        << first.levels << " levels, " << first.moves << " moves, " << first.wins << " wins per pass\n"
+        << "Diverged: " << first.divergedMoves << " moves, " << first.divergedWins << " wins"
+        << (malformed ? ", " + std::to_string(malformed) + " malformed matches" : std::string())
+        << (dropped.empty() ? std::string() : ", " + std::to_string(dropped.size()) + " matches dropped while recording")
+        << "\n"
+        << "Time: " << seconds * 1000 << " ms for " << simulated << " s of play ("
+        << (seconds > 0 ? simulated / seconds : 0) << "x real time, "
+        << (seconds > 0 ? first.moves * opts.repeat / seconds : 0) << " moves/s)\n";
+
+    logging::flush();
+    return first.divergedMoves == 0 && first.divergedWins == 0 && malformed == 0 ? 0 : 2;
+}
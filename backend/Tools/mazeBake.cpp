@@ -0,0 +1,59 @@
+// Bakes a maze library for LABYRINTH_MAZE_LIBRARY:
+//     MazeBake <output.lbml> [mazes per size = 8]
+// Covers every size Game can ask for: single-player levels are
+// 10 * difficulty + 2 * level + 1..5 (levels 0-4), local games are 20, and
+// even sizes are rounded up to odd.
+#include "../Game/Declarations/labyrinth.hpp"
+#include "../Game/Declarations/mazeLibrary.hpp"
+#include "../Game/Declarations/Difficulty.hpp"
+#include "../Game/Declarations/logger.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <output.lbml> [mazes per size]\n";
+        return 1;
+    }
+    const std::string output = argv[1];
+    const int perSize = argc > 2 ? std::atoi(argv[2]) : 8;
+    if (perSize <= 0) {
+        std::cerr << "mazes per size must be positive\n";
+        return 1;
+    }
+
+    std::set<int> sizes{ 21 };
+    for (Difficulty difficulty : { EASY, MEDIUM, HARD }) {
+        for (int level = 0; level < 5; ++level) {
+            for (int variation = 1; variation <= 5; ++variation) {
+                int size = 10 * difficulty + level * 2 + variation;
+                sizes.insert(size % 2 == 0 ? size + 1 : size);   // As labyrinthMap rounds it
+            }
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<labyrinthMap> mazes;
+    for (int size : sizes) {
+        for (int i = 0; i < perSize; ++i) {
+            labyrinthMap map(size, size);
+            map.generateLabyrinth();
+            map.buildGoalDistances();
+            mazes.push_back(std::move(map));
+        }
+    }
+
+    if (!mazeLibrary::write(output, mazes)) {
+        logging::flush();
+        return 1;
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Baked " << mazes.size() << " mazes over " << sizes.size() << " sizes into "
+        << output << " in " << elapsed << " ms\n";
+    return 0;
+}
@@ -1,5 +1,9 @@
-﻿#include "Game/Declarations/game.hpp"
+﻿#include "Game/Declarations/roomManager.hpp"
+#include "Game/Declarations/logger.hpp"
+#include "Game/Declarations/matchRecorder.hpp"
+#include <cstdlib>
 #include <iostream>
+#include <thread>
 
 int main() {
     std::cout << "======================================" << std::endl;
@@ -7,9 +11,45 @@ int main() {
     std::cout << "======================================" << std::endl;
     std::cout << "🧠 Waiting for frontend to send config (mode + difficulty)..." << std::endl;
 
-    Game game;
-    game.run();  // Starts WebSocket server and waits for config to trigger startGame()
+    // LABYRINTH_THREADS overrides the event-loop thread count (default: one per core)
+    unsigned threads = std::thread::hardware_concurrency();
+    if (const char* env = std::getenv("LABYRINTH_THREADS")) {
+        threads = static_cast<unsigned>(std::strtoul(env, nullptr, 10));
+    }
 
+    // LABYRINTH_LOG raises or lowers the runtime log level (debug, info, warn, error)
+    logging::level logLevel;
+    if (const char* env = std::getenv("LABYRINTH_LOG")) {
+        if (logging::parseLevel(env, logLevel)) logging::setLevel(logLevel);
+    }
+
+    // LABYRINTH_POOL_LOW / LABYRINTH_POOL_HIGH set the maze pool watermarks per size
+    mazePoolConfig pool;
+    if (const char* env = std::getenv("LABYRINTH_POOL_LOW")) {
+        pool.lowWater = std::strtoul(env, nullptr, 10);
+    }
+    if (const char* env = std::getenv("LABYRINTH_POOL_HIGH")) {
+        pool.highWater = std::strtoul(env, nullptr, 10);
+    }
+
+    // LABYRINTH_MAZE_LIBRARY names a library baked with MazeBake
+    if (const char* env = std::getenv("LABYRINTH_MAZE_LIBRARY")) {
+        pool.libraryPath = env;
+    }
+
+    // LABYRINTH_RECORD appends every match to a recording for MatchReplay
+    if (const char* env = std::getenv("LABYRINTH_RECORD")) {
+        recording::recorder::open(env);
+    }
+
+    {
+        roomManager rooms(threads, pool);
+        rooms.run();  // Starts WebSocket server; each room waits for its own config to trigger startGame(). Returns on SIGINT/SIGTERM
+    }
+
+    // After the rooms are gone, so matches still running hand over their tails
+    recording::recorder::close();
+    logging::flush();
     return 0;
 }
 